@@ -0,0 +1,325 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmCTestCoordinatorHandler.h"
+#include "cmCTestRunTest.h"
+#include "cmProcess.h"
+#include "cmCTest.h"
+#include "cmSystemTools.h"
+
+//---------------------------------------------------------
+cmCTestCoordinatorHandler::cmCTestCoordinatorHandler()
+{
+  this->WorkerCount = 1;
+}
+
+//---------------------------------------------------------
+cmCTestCoordinatorHandler::~cmCTestCoordinatorHandler()
+{
+  this->StopWorkers();
+}
+
+//---------------------------------------------------------
+void cmCTestCoordinatorHandler::RunTests()
+{
+  for(int k = 1; k <= this->WorkerCount; ++k)
+    {
+    Worker w;
+    w.Id = k;
+    if(this->StartWorker(w))
+      {
+      this->Workers.push_back(w);
+      }
+    }
+  if(this->Workers.empty())
+    {
+    cmCTestLog(this->CTest, ERROR_MESSAGE, "No test workers could be "
+               "started.  Running the tests in this process." << std::endl);
+    }
+  else
+    {
+    cmCTestLog(this->CTest, HANDLER_OUTPUT, "Running tests in "
+               << this->Workers.size() << " worker processes" << std::endl);
+    this->SetParallelLevel(this->Workers.size());
+    }
+  this->cmCTestMultiProcessHandler::RunTests();
+  this->StopWorkers();
+}
+
+//---------------------------------------------------------
+bool cmCTestCoordinatorHandler::StartWorker(Worker& w)
+{
+  // The worker reads the same test list in the same directory, so
+  // only the options that affect how a test runs are passed on.
+  std::vector<std::string> args;
+  cmSystemTools::ExpandListArgument(this->CTest->GetWorkerLauncher(), args);
+  args.push_back(this->CTest->GetCTestExecutable());
+  args.push_back("--worker");
+  cmOStringStream id;
+  id << w.Id;
+  args.push_back(id.str());
+  if(!this->CTest->GetConfigType().empty())
+    {
+    args.push_back("-C");
+    args.push_back(this->CTest->GetConfigType());
+    }
+  if(this->CTest->GetGlobalTimeout() > 0)
+    {
+    cmOStringStream timeout;
+    timeout << this->CTest->GetGlobalTimeout();
+    args.push_back("--timeout");
+    args.push_back(timeout.str());
+    }
+  if(!this->CTest->GetStopTime().empty())
+    {
+    args.push_back("--stop-time");
+    args.push_back(this->CTest->GetStopTime());
+    }
+  if(!this->CTest->ShouldCompressTestOutput())
+    {
+    args.push_back("--no-compress-output");
+    }
+
+  w.Process = new cmProcess;
+  w.Process->SetId(w.Id);
+  w.Process->SetCommand(args[0].c_str());
+  w.Process->SetCommandArguments(
+    std::vector<std::string>(args.begin() + 1, args.end()));
+  if(w.Process->OpenInputPipe() && w.Process->StartProcess())
+    {
+    cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, "Started test worker "
+               << w.Id << ":");
+    for(std::vector<std::string>::const_iterator i = args.begin();
+        i != args.end(); ++i)
+      {
+      cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, " " << *i);
+      }
+    cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, std::endl);
+    return true;
+    }
+  cmCTestLog(this->CTest, ERROR_MESSAGE, "Could not start test worker "
+             << w.Id << ": " << args[0] << std::endl);
+  delete w.Process;
+  w.Process = 0;
+  return false;
+}
+
+//---------------------------------------------------------
+void cmCTestCoordinatorHandler::StopWorkers()
+{
+  // Workers exit when they read end of file.
+  for(std::vector<Worker>::iterator i = this->Workers.begin();
+      i != this->Workers.end(); ++i)
+    {
+    if(i->Process)
+      {
+      i->Process->CloseInputPipe();
+      }
+    }
+  for(std::vector<Worker>::iterator i = this->Workers.begin();
+      i != this->Workers.end(); ++i)
+    {
+    if(i->Process)
+      {
+      std::string line;
+      int p;
+      while((p = i->Process->GetNextOutputLine(line, 1))
+            != cmsysProcess_Pipe_None)
+        {
+        if(p != cmsysProcess_Pipe_Timeout)
+          {
+          cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, "worker "
+                     << i->Id << ": " << line << std::endl);
+          }
+        }
+      delete i->Process;
+      i->Process = 0;
+      }
+    }
+  this->Workers.clear();
+}
+
+//---------------------------------------------------------
+void cmCTestCoordinatorHandler::StartTestProcess(int test)
+{
+  if(this->Workers.empty())
+    {
+    this->cmCTestMultiProcessHandler::StartTestProcess(test);
+    return;
+    }
+  this->TestRunningMap[test] = true; // mark the test as running
+  // now remove the test itself
+  this->EraseTest(test);
+  this->LockResources(test);
+
+  cmCTestTestHandler::cmCTestTestProperties* p = this->Properties[test];
+  cmCTestLog(this->CTest, HANDLER_OUTPUT,
+             std::setw(2*getNumWidth(this->Total) + 8) << "Start "
+             << std::setw(getNumWidth(this->TestHandler->GetMaxIndex()))
+             << p->Index << ": " << p->Name << std::endl);
+
+  // Hand the test to an idle worker.
+  cmOStringStream request;
+  request << test << "\n";
+  for(std::vector<Worker>::iterator i = this->Workers.begin();
+      i != this->Workers.end(); ++i)
+    {
+    if(i->Process && i->Test < 0 && i->Process->WriteInput(request.str()))
+      {
+      i->Test = test;
+      return;
+      }
+    }
+
+  // Workers that exited and could not be replaced leave fewer
+  // processes than the parallel level.
+  cmCTestWorkerHandler::Record r;
+  r.Index = test;
+  r.Result.Output = "No test worker is available to run the test";
+  cmCTestLog(this->CTest, ERROR_MESSAGE, r.Result.Output << ": "
+             << p->Name << std::endl);
+  this->Completed++;
+  this->FinishTestProcess(test, this->ReportResult(test, r));
+}
+
+//---------------------------------------------------------
+bool cmCTestCoordinatorHandler::CheckOutput()
+{
+  if(this->Workers.empty())
+    {
+    return this->cmCTestMultiProcessHandler::CheckOutput();
+    }
+  bool running = false;
+  std::vector<cmProcess*> procs;
+  for(std::vector<Worker>::iterator i = this->Workers.begin();
+      i != this->Workers.end(); ++i)
+    {
+    if(i->Test >= 0)
+      {
+      running = true;
+      }
+    if(i->Process)
+      {
+      procs.push_back(i->Process);
+      }
+    }
+  // no more output we are done
+  if(!running)
+    {
+    return false;
+    }
+  double timeout = cmProcess::WaitForAny(procs)? 0 : 0.1;
+
+  std::vector<Worker*> finished;
+  for(std::vector<Worker>::iterator i = this->Workers.begin();
+      i != this->Workers.end(); ++i)
+    {
+    if(i->Process && this->ReadWorker(*i, timeout))
+      {
+      finished.push_back(&*i);
+      }
+    }
+  for(std::vector<Worker*>::iterator i = finished.begin();
+      i != finished.end(); ++i)
+    {
+    Worker* w = *i;
+    int test = w->Test;
+    w->Test = -1;
+    this->Completed++;
+    this->FinishTestProcess(test, this->ReportResult(test, w->Result));
+    }
+  return true;
+}
+
+//---------------------------------------------------------
+bool cmCTestCoordinatorHandler::ReadWorker(Worker& w, double timeout)
+{
+  std::string line;
+  for(;;)
+    {
+    int p = w.Process->GetNextOutputLine(line, timeout);
+    timeout = 0;
+    if(p == cmsysProcess_Pipe_STDOUT)
+      {
+      bool consumed;
+      if(cmCTestWorkerHandler::ReadRecordLine(line, w.Result, consumed))
+        {
+        if(w.Test >= 0 && w.Result.Index == w.Test)
+          {
+          w.TestsRun++;
+          return true;
+          }
+        cmCTestLog(this->CTest, ERROR_MESSAGE, "Test worker " << w.Id
+                   << " sent a result for test " << w.Result.Index
+                   << " it was not running" << std::endl);
+        continue;
+        }
+      else if(consumed)
+        {
+        continue;
+        }
+      }
+    if(p == cmsysProcess_Pipe_STDOUT || p == cmsysProcess_Pipe_STDERR)
+      {
+      cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, "worker " << w.Id
+                 << ": " << line << std::endl);
+      }
+    else if(p == cmsysProcess_Pipe_None)
+      {
+      cmCTestLog(this->CTest, ERROR_MESSAGE, "Test worker " << w.Id
+                 << " exited unexpectedly" << std::endl);
+      delete w.Process;
+      w.Process = 0;
+      bool lost = w.Test >= 0;
+      if(lost)
+        {
+        cmOStringStream reason;
+        reason << "Test worker " << w.Id << " exited while running the test";
+        w.Result = cmCTestWorkerHandler::Record();
+        w.Result.Index = w.Test;
+        w.Result.Result.Status = cmCTestTestHandler::FAILED;
+        w.Result.Result.CompletionStatus = "Worker exited";
+        w.Result.Result.Reason = reason.str();
+        }
+      // Replace a worker that has shown that it can run tests.  One
+      // that cannot is not restarted over and over.
+      if(w.TestsRun > 0)
+        {
+        this->StartWorker(w);
+        }
+      return lost;
+      }
+    else // if(p == cmsysProcess_Pipe_Timeout)
+      {
+      return false;
+      }
+    }
+}
+
+//---------------------------------------------------------
+bool cmCTestCoordinatorHandler::ReportResult(int test,
+                                             cmCTestWorkerHandler::Record& r)
+{
+  cmCTestTestHandler::cmCTestTestProperties* p = this->Properties[test];
+  cmCTestTestHandler::cmCTestTestResult& res = r.Result;
+  res.Name = p->Name;
+  res.Path = p->Directory;
+  res.TestCount = p->Index;
+  res.Properties = p;
+
+  cmCTestRunTest::WriteResultLine(this->TestHandler, p, this->Completed,
+                                  this->Total, res, res.ExecutionTime,
+                                  r.FailureOutput);
+  *this->TestHandler->LogFile << r.Log;
+  cmCTestRunTest::UpdateCost(p, res);
+  this->TestResults->push_back(res);
+  return res.Status == cmCTestTestHandler::COMPLETED;
+}
@@ -0,0 +1,65 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmCTestCoordinatorHandler_h
+#define cmCTestCoordinatorHandler_h
+
+#include <cmStandardIncludes.h>
+#include <cmCTestTestHandler.h>
+#include <cmCTestMultiProcessHandler.h>
+#include <cmCTestWorkerHandler.h>
+
+class cmProcess;
+
+/** \class cmCTestCoordinatorHandler
+ * \brief run tests in worker ctest processes
+ *
+ * cmCTestCoordinatorHandler schedules the tests as
+ * cmCTestMultiProcessHandler does but hands each test to one of a set
+ * of "ctest --worker" processes over its standard input.  The results
+ * the workers send back are reported and logged as if the tests had
+ * run in this process.
+ */
+class cmCTestCoordinatorHandler : public cmCTestMultiProcessHandler
+{
+public:
+  cmCTestCoordinatorHandler();
+  ~cmCTestCoordinatorHandler();
+  void SetWorkers(int workers) { this->WorkerCount = workers; }
+  virtual void RunTests();
+protected:
+  virtual void StartTestProcess(int test);
+  virtual bool CheckOutput();
+
+  struct Worker
+  {
+    Worker(): Id(0), Process(0), Test(-1), TestsRun(0) {}
+    int Id;
+    cmProcess* Process;
+    // The test being run, or -1 if idle
+    int Test;
+    int TestsRun;
+    // The result being read
+    cmCTestWorkerHandler::Record Result;
+  };
+
+  bool StartWorker(Worker& w);
+  void StopWorkers();
+  // Read what a worker has to say.  Returns true when its test is done.
+  bool ReadWorker(Worker& w, double timeout);
+  // Report and record the result of a test, returning whether it passed
+  bool ReportResult(int test, cmCTestWorkerHandler::Record& r);
+
+  int WorkerCount;
+  std::vector<Worker> Workers;
+};
+
+#endif
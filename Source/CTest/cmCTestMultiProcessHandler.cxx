@@ -36,6 +36,23 @@ cmCTestMultiProcessHandler::SetTests(TestMap& tests,
 {
   this->Tests = tests;
   this->Properties = properties;
+  // index the tests by name, later tests taking precedence
+  for(PropertiesMap::iterator i = this->Properties.begin();
+      i != this->Properties.end(); ++i)
+    {
+    this->TestIndices[i->second->Name] = i->first;
+    }
+  // ctest -N --shard shows the tests of the shard, which are chosen
+  // by cost.
+  bool shard = this->CTest->GetShardCount() > 1;
+  if(!this->CTest->GetShowOnly() || shard)
+    {
+    this->ReadCostData();
+    }
+  if(shard)
+    {
+    this->SelectShard();
+    }
   this->Total = this->Tests.size();
   // set test run map to false for all
   for(TestMap::iterator i = this->Tests.begin();
@@ -43,14 +60,173 @@ cmCTestMultiProcessHandler::SetTests(TestMap& tests,
     {
     this->TestRunningMap[i->first] = false;
     this->TestFinishMap[i->first] = false;
+    for(TestSet::const_iterator j = i->second.begin();
+        j != i->second.end(); ++j)
+      {
+      this->Dependents[*j].insert(i->first);
+      }
     }
   if(!this->CTest->GetShowOnly())
     {
-    this->ReadCostData();
     this->CreateTestCostList();
     }
 }
 
+//---------------------------------------------------------
+static int cmCTestShardFindGroup(std::map<int, int>& parent, int test)
+{
+  while(parent[test] != test)
+    {
+    parent[test] = parent[parent[test]];
+    test = parent[test];
+    }
+  return test;
+}
+
+//---------------------------------------------------------
+struct cmCTestShardGroup
+{
+  cmCTestShardGroup(): Cost(0) {}
+  float Cost;
+  // least test name in the group, to order groups of equal cost
+  std::string Name;
+  std::vector<int> Tests;
+};
+
+//---------------------------------------------------------
+static bool cmCTestShardGroupLess(cmCTestShardGroup const& l,
+                                  cmCTestShardGroup const& r)
+{
+  if(l.Cost != r.Cost)
+    {
+    return l.Cost > r.Cost;
+    }
+  return l.Name < r.Name;
+}
+
+//---------------------------------------------------------
+void cmCTestMultiProcessHandler::SelectShard()
+{
+  size_t shards = this->CTest->GetShardCount();
+  size_t shard = this->CTest->GetShardIndex() - 1;
+
+  // Tests joined by DEPENDS or by a RESOURCE_LOCK form a group that
+  // goes to one shard.
+  std::map<int, int> parent;
+  for(TestMap::iterator i = this->Tests.begin(); i != this->Tests.end(); ++i)
+    {
+    parent[i->first] = i->first;
+    }
+  std::map<std::string, int> lockHolders;
+  for(TestMap::iterator i = this->Tests.begin(); i != this->Tests.end(); ++i)
+    {
+    int test = cmCTestShardFindGroup(parent, i->first);
+    for(TestSet::const_iterator j = i->second.begin();
+        j != i->second.end(); ++j)
+      {
+      if(parent.find(*j) != parent.end())
+        {
+        parent[cmCTestShardFindGroup(parent, *j)] = test;
+        }
+      }
+    std::set<std::string> const& locks =
+      this->Properties[i->first]->LockedResources;
+    for(std::set<std::string>::const_iterator j = locks.begin();
+        j != locks.end(); ++j)
+      {
+      std::map<std::string, int>::iterator h = lockHolders.find(*j);
+      if(h == lockHolders.end())
+        {
+        lockHolders[*j] = test;
+        }
+      else
+        {
+        parent[cmCTestShardFindGroup(parent, h->second)] = test;
+        }
+      }
+    }
+
+  // Weigh each test by its cost, except that random costs mean
+  // nothing, and by the average known cost if it has none.
+  bool random = this->CTest->GetScheduleType() == "Random";
+  std::map<int, float> costs;
+  float known = 0;
+  int numKnown = 0;
+  for(TestMap::iterator i = this->Tests.begin(); i != this->Tests.end(); ++i)
+    {
+    float cost = random? 0 : this->Properties[i->first]->Cost;
+    std::map<int, float>::const_iterator r =
+      this->RecordedCosts.find(i->first);
+    if(cost <= 0 && r != this->RecordedCosts.end())
+      {
+      cost = r->second;
+      }
+    costs[i->first] = cost;
+    if(cost > 0)
+      {
+      known += cost;
+      numKnown++;
+      }
+    }
+  float unknown = numKnown? known / numKnown : 1;
+
+  std::map<int, cmCTestShardGroup> groupMap;
+  for(TestMap::iterator i = this->Tests.begin(); i != this->Tests.end(); ++i)
+    {
+    cmCTestShardGroup& g =
+      groupMap[cmCTestShardFindGroup(parent, i->first)];
+    std::string const& name = this->Properties[i->first]->Name;
+    g.Cost += costs[i->first] > 0? costs[i->first] : unknown;
+    g.Tests.push_back(i->first);
+    if(g.Name.empty() || name < g.Name)
+      {
+      g.Name = name;
+      }
+    }
+  std::vector<cmCTestShardGroup> groups;
+  for(std::map<int, cmCTestShardGroup>::const_iterator i = groupMap.begin();
+      i != groupMap.end(); ++i)
+    {
+    groups.push_back(i->second);
+    }
+  std::sort(groups.begin(), groups.end(), cmCTestShardGroupLess);
+
+  // Hand the costliest group left to the least loaded shard.  Every
+  // shard computes the same assignment from the same cost data.
+  std::vector<float> load(shards, 0);
+  size_t total = this->Tests.size();
+  for(std::vector<cmCTestShardGroup>::const_iterator g = groups.begin();
+      g != groups.end(); ++g)
+    {
+    size_t least = 0;
+    for(size_t s = 1; s < shards; ++s)
+      {
+      if(load[s] < load[least])
+        {
+        least = s;
+        }
+      }
+    load[least] += g->Cost;
+    if(least == shard)
+      {
+      continue;
+      }
+    for(std::vector<int>::const_iterator t = g->Tests.begin();
+        t != g->Tests.end(); ++t)
+      {
+      this->Tests.erase(*t);
+      this->TestIndices.erase(this->Properties[*t]->Name);
+      this->Properties.erase(*t);
+      }
+    }
+
+  char buf[1024];
+  sprintf(buf, "%.2f sec", load[shard]);
+  cmCTestLog(this->CTest, HANDLER_OUTPUT, "Shard " << (shard + 1) << "/"
+             << shards << ": " << this->Tests.size() << " of " << total
+             << " tests, " << buf << " estimated" << std::endl);
+}
+
   // Set the max number of tests that can be run at the same time.
 void cmCTestMultiProcessHandler::SetParallelLevel(size_t level)
 {
@@ -66,6 +242,9 @@ void cmCTestMultiProcessHandler::RunTests()
     return;
     }
   this->TestHandler->SetMaxIndex(this->FindMaxIndex());
+  bool criticalPath = this->CTest->GetScheduleType() == "CriticalPath";
+  double predicted = criticalPath? this->PredictTotalTime() : 0;
+  double start = cmSystemTools::GetTime();
   this->StartNextTests();
   while(this->Tests.size() != 0)
     {
@@ -78,6 +257,14 @@ void cmCTestMultiProcessHandler::RunTests()
     }
   this->MarkFinished();
   this->UpdateCostData();
+  if(criticalPath)
+    {
+    char buf[1024];
+    sprintf(buf, "%6.2f sec predicted, %6.2f sec actual",
+            predicted, cmSystemTools::GetTime() - start);
+    cmCTestLog(this->CTest, HANDLER_OUTPUT,
+               "\nCritical path schedule: " << buf << "\n");
+    }
 }
 
 //---------------------------------------------------------
@@ -142,14 +329,21 @@ void cmCTestMultiProcessHandler::UnlockResources(int index)
 void cmCTestMultiProcessHandler::EraseTest(int test)
 {
   this->Tests.erase(test);
-  for(TestCostMap::iterator i = this->TestCosts.begin();
-      i != this->TestCosts.end(); ++i)
+  std::map<int, float>::iterator k = this->TestCostKeys.find(test);
+  if(k != this->TestCostKeys.end())
     {
-    if(i->second.find(test) != i->second.end())
+    TestCostMap::iterator i = this->TestCosts.find(k->second);
+    if(i != this->TestCosts.end())
       {
       i->second.erase(test);
-      return;
+      // StartNextTests may be iterating over the map, so leave it to
+      // remove the entry once it is empty.
+      if(i->second.empty())
+        {
+        this->EmptiedTestCosts.push_back(i->first);
+        }
       }
+    this->TestCostKeys.erase(k);
     }
 }
 
@@ -226,6 +420,18 @@ bool cmCTestMultiProcessHandler::StartTest(int test)
 //---------------------------------------------------------
 void cmCTestMultiProcessHandler::StartNextTests()
 {
+  // Drop cost entries whose tests have all started.
+  for(std::vector<float>::const_iterator e = this->EmptiedTestCosts.begin();
+      e != this->EmptiedTestCosts.end(); ++e)
+    {
+    TestCostMap::iterator i = this->TestCosts.find(*e);
+    if(i != this->TestCosts.end() && i->second.empty())
+      {
+      this->TestCosts.erase(i);
+      }
+    }
+  this->EmptiedTestCosts.clear();
+
   size_t numToStart = this->ParallelLevel - this->RunningCount;
   if(numToStart == 0)
     {
@@ -268,6 +474,18 @@ void cmCTestMultiProcessHandler::StartNextTests()
     }
 }
 
+//---------------------------------------------------------
+bool cmCTestMultiProcessHandler::WaitForRunningTests()
+{
+  std::vector<cmProcess*> procs;
+  for(std::set<cmCTestRunTest*>::const_iterator i = this->RunningTests.begin();
+      i != this->RunningTests.end(); ++i)
+    {
+    procs.push_back((*i)->GetProcess());
+    }
+  return cmProcess::WaitForAny(procs);
+}
+
 //---------------------------------------------------------
 bool cmCTestMultiProcessHandler::CheckOutput()
 {
@@ -276,13 +494,18 @@ bool cmCTestMultiProcessHandler::CheckOutput()
     {
     return false;
     }
+  // Read what the running tests have to say after waiting for any of
+  // them to say something.  Where that wait is not supported give
+  // each test a moment in turn instead.
+  double timeout = this->WaitForRunningTests()? 0 : 0.1;
+
   std::vector<cmCTestRunTest*> finished;
   std::string out, err;
   for(std::set<cmCTestRunTest*>::const_iterator i = this->RunningTests.begin();
       i != this->RunningTests.end(); ++i)
     {
     cmCTestRunTest* p = *i;
-    if(!p->CheckOutput())
+    if(!p->CheckOutput(timeout))
       {
       finished.push_back(p);
       }
@@ -293,31 +516,42 @@ bool cmCTestMultiProcessHandler::CheckOutput()
     this->Completed++;
     cmCTestRunTest* p = *i;
     int test = p->GetIndex();
-
-    if(p->EndTest(this->Completed, this->Total, true))
-      {
-      this->Passed->push_back(p->GetTestProperties()->Name);
-      }
-    else
-      {
-      this->Failed->push_back(p->GetTestProperties()->Name);
-      }
-    for(TestMap::iterator j = this->Tests.begin();
-        j != this->Tests.end(); ++j)
-      {
-      j->second.erase(test);
-      }
-    this->TestFinishMap[test] = true;
-    this->TestRunningMap[test] = false;
+    bool passed = p->EndTest(this->Completed, this->Total, true);
     this->RunningTests.erase(p);
-    this->WriteCheckpoint(test);
-    this->UnlockResources(test);
-    this->RunningCount -= GetProcessorsUsed(test);
     delete p;
+    this->FinishTestProcess(test, passed);
     }
   return true;
 }
 
+//---------------------------------------------------------
+void cmCTestMultiProcessHandler::FinishTestProcess(int test, bool passed)
+{
+  if(passed)
+    {
+    this->Passed->push_back(this->Properties[test]->Name);
+    }
+  else
+    {
+    this->Failed->push_back(this->Properties[test]->Name);
+    }
+  TestSet const& dependents = this->Dependents[test];
+  for(TestSet::const_iterator j = dependents.begin();
+      j != dependents.end(); ++j)
+    {
+    TestMap::iterator d = this->Tests.find(*j);
+    if(d != this->Tests.end())
+      {
+      d->second.erase(test);
+      }
+    }
+  this->TestFinishMap[test] = true;
+  this->TestRunningMap[test] = false;
+  this->WriteCheckpoint(test);
+  this->UnlockResources(test);
+  this->RunningCount -= GetProcessorsUsed(test);
+}
+
 //---------------------------------------------------------
 void cmCTestMultiProcessHandler::UpdateCostData()
 {
@@ -414,6 +648,7 @@ void cmCTestMultiProcessHandler::ReadCostData()
       if(index == -1) continue;
 
       this->Properties[index]->PreviousRuns = prev;
+      this->RecordedCosts[index] = cost;
       if(this->Properties[index] && this->Properties[index]->Cost == 0)
         {
         this->Properties[index]->Cost = cost;
@@ -434,36 +669,201 @@ void cmCTestMultiProcessHandler::ReadCostData()
 //---------------------------------------------------------
 int cmCTestMultiProcessHandler::SearchByName(std::string name)
 {
-  int index = -1;
-
-  for(PropertiesMap::iterator i = this->Properties.begin();
-      i != this->Properties.end(); ++i)
+  // Tests removed when resuming an interrupted run are not found.
+  std::map<cmStdString, int>::const_iterator i = this->TestIndices.find(name);
+  if(i == this->TestIndices.end() ||
+     this->Properties.find(i->second) == this->Properties.end())
     {
-    if(i->second->Name == name)
-      {
-      index = i->first;
-      }
+    return -1;
     }
-  return index;
+  return i->second;
 }
 
 //---------------------------------------------------------
 void cmCTestMultiProcessHandler::CreateTestCostList()
 {
+  std::set<std::string> lastTestsFailed(this->LastTestsFailed.begin(),
+                                        this->LastTestsFailed.end());
+
+  // Order by the critical path through each test if requested and by
+  // the cost of the test alone otherwise.
+  std::map<int, float> weights;
+  if(this->CTest->GetScheduleType() == "CriticalPath")
+    {
+    this->ComputeCriticalPathWeights(weights);
+    }
   for(TestMap::iterator i = this->Tests.begin();
       i != this->Tests.end(); ++i)
     {
     std::string name = this->Properties[i->first]->Name;
-    if(std::find(this->LastTestsFailed.begin(), this->LastTestsFailed.end(),
-       name) != this->LastTestsFailed.end())
+    float key;
+    if(lastTestsFailed.find(name) != lastTestsFailed.end())
+      {
+      key = FLT_MAX;
+      }
+    else if(!weights.empty())
       {
-      this->TestCosts[FLT_MAX].insert(i->first);
+      key = weights[i->first];
       }
     else
       {
-      this->TestCosts[this->Properties[i->first]->Cost].insert(i->first);
+      key = this->Properties[i->first]->Cost;
+      }
+    this->TestCosts[key].insert(i->first);
+    this->TestCostKeys[i->first] = key;
+    }
+}
+
+//---------------------------------------------------------
+void
+cmCTestMultiProcessHandler::ComputeCriticalPathWeights(
+  std::map<int, float>& weights)
+{
+  // Count the tests waiting on each test.
+  std::map<int, size_t> waiting;
+  for(TestMap::iterator i = this->Tests.begin();
+      i != this->Tests.end(); ++i)
+    {
+    waiting[i->first];
+    for(TestSet::const_iterator j = i->second.begin();
+        j != i->second.end(); ++j)
+      {
+      if(this->Tests.find(*j) != this->Tests.end())
+        {
+        ++waiting[*j];
+        }
+      }
+    }
+
+  // Start from the tests nothing waits on and work back through the
+  // DEPENDS graph.  A test is weighed once all tests waiting on it
+  // have been, so the graph may be of any depth.  Tests in a cycle,
+  // which CheckCycles reports later, keep their own cost.
+  std::vector<int> ready;
+  for(TestMap::iterator i = this->Tests.begin();
+      i != this->Tests.end(); ++i)
+    {
+    weights[i->first] = 0;
+    if(waiting[i->first] == 0)
+      {
+      ready.push_back(i->first);
+      }
+    }
+  while(!ready.empty())
+    {
+    int test = ready.back();
+    ready.pop_back();
+    float weight = weights[test] + this->Properties[test]->Cost;
+    weights[test] = weight;
+    TestSet const& depends = this->Tests[test];
+    for(TestSet::const_iterator j = depends.begin(); j != depends.end(); ++j)
+      {
+      if(this->Tests.find(*j) == this->Tests.end())
+        {
+        continue;
+        }
+      if(weights[*j] < weight)
+        {
+        weights[*j] = weight;
+        }
+      if(--waiting[*j] == 0)
+        {
+        ready.push_back(*j);
+        }
+      }
+    }
+  for(std::map<int, size_t>::const_iterator i = waiting.begin();
+      i != waiting.end(); ++i)
+    {
+    if(i->second != 0)
+      {
+      weights[i->first] = this->Properties[i->first]->Cost;
+      }
+    }
+}
+
+//---------------------------------------------------------
+double cmCTestMultiProcessHandler::PredictTotalTime()
+{
+  // Rank the tests in the order StartNextTests considers them.
+  std::map<int, size_t> rank;
+  std::vector<int> order;
+  for(TestCostMap::reverse_iterator i = this->TestCosts.rbegin();
+      i != this->TestCosts.rend(); ++i)
+    {
+    for(TestSet::const_iterator j = i->second.begin();
+        j != i->second.end(); ++j)
+      {
+      if(this->Tests.find(*j) != this->Tests.end() &&
+         rank.insert(std::make_pair(*j, order.size())).second)
+        {
+        order.push_back(*j);
+        }
+      }
+    }
+
+  // Count the unfinished depends of each test and find the tests
+  // waiting on each.
+  std::map<int, size_t> pending;
+  std::map<int, std::vector<int> > waiting;
+  std::set<size_t> ready;
+  for(std::vector<int>::const_iterator i = order.begin();
+      i != order.end(); ++i)
+    {
+    TestSet const& depends = this->Tests[*i];
+    size_t& n = pending[*i];
+    for(TestSet::const_iterator j = depends.begin(); j != depends.end(); ++j)
+      {
+      if(rank.find(*j) != rank.end())
+        {
+        waiting[*j].push_back(*i);
+        ++n;
+        }
+      }
+    if(n == 0)
+      {
+      ready.insert(rank[*i]);
       }
     }
+
+  // Start ready tests in order while they fit and advance to the next
+  // test to finish.  Resource locks are not modeled.
+  std::multimap<double, int> running;
+  size_t available = this->ParallelLevel;
+  double now = 0;
+  for(;;)
+    {
+    while(!ready.empty())
+      {
+      int test = order[*ready.begin()];
+      size_t processors = this->GetProcessorsUsed(test);
+      if(processors > available)
+        {
+        break;
+        }
+      ready.erase(ready.begin());
+      available -= processors;
+      running.insert(std::make_pair(now + this->Properties[test]->Cost,
+                                    test));
+      }
+    if(running.empty())
+      {
+      break;
+      }
+    now = running.begin()->first;
+    int test = running.begin()->second;
+    running.erase(running.begin());
+    available += this->GetProcessorsUsed(test);
+    std::vector<int> const& w = waiting[test];
+    for(std::vector<int>::const_iterator i = w.begin(); i != w.end(); ++i)
+      {
+      if(--pending[*i] == 0)
+        {
+        ready.insert(rank[*i]);
+        }
+      }
+    }
+  return now;
 }
 
 //---------------------------------------------------------
@@ -588,40 +988,53 @@ bool cmCTestMultiProcessHandler::CheckCycles()
 {
   cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT, 
              "Checking test dependency graph..." << std::endl);
+  // Search depth first from each test not yet visited, marking the
+  // tests on the current path.  Reaching one of them again closes a
+  // cycle.  Each test and dependency is visited once.
+  enum { Unvisited, OnPath, Done };
+  typedef std::pair<int, TestSet::const_iterator> PathEntry;
+  std::map<int, int> state;
   for(TestMap::iterator it = this->Tests.begin();
       it != this->Tests.end(); ++it)
     {
-    //DFS from each element to itself
-    std::stack<int> s;
-    std::vector<int> visited;
-    s.push(it->first);
-    visited.push_back(it->first);
-
+    if(state[it->first] != Unvisited)
+      {
+      continue;
+      }
+    std::stack<PathEntry> s;
+    state[it->first] = OnPath;
+    s.push(PathEntry(it->first, it->second.begin()));
     while(!s.empty())
       {
-      int test = s.top();
-      s.pop();
-      
-      for(TestSet::iterator d = this->Tests[test].begin();
-          d != this->Tests[test].end(); ++d)
+      int test = s.top().first;
+      TestSet::const_iterator d = s.top().second;
+      if(d == this->Tests.find(test)->second.end())
         {
-        s.push(*d);
-        for(std::vector<int>::iterator v = visited.begin();
-            v != visited.end(); ++v)
-          {
-          if(*v == *d)
-            {
-            //cycle exists
-            cmCTestLog(this->CTest, ERROR_MESSAGE, "Error: a cycle exists in "
-              "the test dependency graph for the test \""
-              << this->Properties[*d]->Name << "\"." << std::endl
-              << "Please fix the cycle and run ctest again." << std::endl);
-            return false;
-            }
-          }
-        visited.push_back(*d);
+        state[test] = Done;
+        s.pop();
+        continue;
+        }
+      ++s.top().second;
+      TestMap::iterator dep = this->Tests.find(*d);
+      if(dep == this->Tests.end())
+        {
+        continue;
+        }
+      int& depState = state[*d];
+      if(depState == OnPath)
+        {
+        //cycle exists
+        cmCTestLog(this->CTest, ERROR_MESSAGE, "Error: a cycle exists in "
+          "the test dependency graph for the test \""
+          << this->Properties[*d]->Name << "\"." << std::endl
+          << "Please fix the cycle and run ctest again." << std::endl);
+        return false;
+        }
+      else if(depState == Unvisited)
+        {
+        depState = OnPath;
+        s.push(PathEntry(*d, dep->second.begin()));
         }
-      visited.pop_back();
       }
     }
   return true;
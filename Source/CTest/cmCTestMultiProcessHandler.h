@@ -59,7 +59,7 @@ protected:
   // Start the next test or tests as many as are allowed by
   // ParallelLevel
   void StartNextTests();
-  void StartTestProcess(int test);
+  virtual void StartTestProcess(int test);
   bool StartTest(int test);
   // Mark the checkpoint for the given test
   void WriteCheckpoint(int index);
@@ -70,12 +70,24 @@ protected:
   int SearchByName(std::string name);
 
   void CreateTestCostList();
+  // Keep only the tests of the shard chosen with --shard, balancing the
+  // shards by test cost
+  void SelectShard();
+  // Weigh each test by the cost of the longest chain of tests that
+  // cannot start before it finishes
+  void ComputeCriticalPathWeights(std::map<int, float>& weights);
+  // Simulate the schedule with the recorded costs
+  double PredictTotalTime();
   // Removes the checkpoint file
   void MarkFinished();
   void EraseTest(int index);
   // Return true if there are still tests running
   // check all running processes for output and exit case
-  bool CheckOutput();
+  virtual bool CheckOutput();
+  // Record a finished test and release what it held
+  void FinishTestProcess(int test, bool passed);
+  // Block until a running test has output or exits
+  bool WaitForRunningTests();
   void RemoveTest(int index);
   //Check if we need to resume an interrupted test set
   void CheckResume();
@@ -88,7 +100,17 @@ protected:
   void UnlockResources(int index);
   // map from test number to set of depend tests
   TestMap Tests;
+  // map from test number to set of tests that depend on it
+  TestMap Dependents;
   TestCostMap TestCosts;
+  // map from test number to its key in TestCosts
+  std::map<int, float> TestCostKeys;
+  // keys of TestCosts entries that may have been emptied
+  std::vector<float> EmptiedTestCosts;
+  // map from test name to test number
+  std::map<cmStdString, int> TestIndices;
+  // map from test number to its cost in the cost data file
+  std::map<int, float> RecordedCosts;
   //Total number of tests we'll be running
   size_t Total;
   //Number of tests that are complete
@@ -39,13 +39,20 @@ cmCTestRunTest::~cmCTestRunTest()
 }
 
 //----------------------------------------------------------------------------
-bool cmCTestRunTest::CheckOutput()
+// Time in seconds to read output that is already available from one
+// test before looking at the others.
+#define CTEST_OUTPUT_READ_BUDGET_IN_SECONDS 0.01
+
+//----------------------------------------------------------------------------
+bool cmCTestRunTest::CheckOutput(double timeout)
 {
-  // Read lines for up to 0.1 seconds of total time.
-  double timeout = 0.1;
-  double timeEnd = cmSystemTools::GetTime() + timeout;
+  // Read lines for up to the given time.  When asked not to wait,
+  // read only what is available, but still for a bounded time so that
+  // a test writing without pause does not hold up the others.
+  double timeEnd = cmSystemTools::GetTime() +
+    (timeout > 0? timeout : CTEST_OUTPUT_READ_BUDGET_IN_SECONDS);
   std::string line;
-  while((timeout = timeEnd - cmSystemTools::GetTime(), timeout > 0))
+  for(;;)
     {
     int p = this->TestProcess->GetNextOutputLine(line, timeout);
     if(p == cmsysProcess_Pipe_None)
@@ -66,6 +73,15 @@ bool cmCTestRunTest::CheckOutput()
       {
       break;
       }
+    double now = cmSystemTools::GetTime();
+    if(now >= timeEnd)
+      {
+      break;
+      }
+    if(timeout > 0)
+      {
+      timeout = timeEnd - now;
+      }
     }
   return true;
 }
@@ -138,7 +154,7 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
     this->CompressOutput();
     }
 
-  this->WriteLogOutputTop(completed, total);
+  this->WriteLogOutputTop();
   std::string reason;
   bool passed = true;
   int res = started ? this->TestProcess->GetProcessStatus()
@@ -147,7 +163,6 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
   std::vector<std::pair<cmsys::RegularExpression,
     std::string> >::iterator passIt;
   bool forceFail = false;
-  bool outputTestErrorsToConsole = false;
   if ( this->TestProperties->RequiredRegularExpressions.size() > 0 )
     {
     bool found = false;
@@ -201,62 +216,45 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
       || (!success && this->TestProperties->WillFail))
       {
       this->TestResult.Status = cmCTestTestHandler::COMPLETED;
-      cmCTestLog(this->CTest, HANDLER_OUTPUT, "   Passed  " );
       }
     else
       {
       this->TestResult.Status = cmCTestTestHandler::FAILED;
-      cmCTestLog(this->CTest, HANDLER_OUTPUT, "***Failed  " << reason );
-      outputTestErrorsToConsole = this->CTest->OutputTestOutputOnTestFailure;
       }
     }
   else if ( res == cmsysProcess_State_Expired )
     {
-    cmCTestLog(this->CTest, HANDLER_OUTPUT, "***Timeout ");
     this->TestResult.Status = cmCTestTestHandler::TIMEOUT;
-    outputTestErrorsToConsole = this->CTest->OutputTestOutputOnTestFailure;
     }
   else if ( res == cmsysProcess_State_Exception )
     {
-    outputTestErrorsToConsole = this->CTest->OutputTestOutputOnTestFailure;
-    cmCTestLog(this->CTest, HANDLER_OUTPUT, "***Exception: ");
     switch ( retVal )
       {
       case cmsysProcess_Exception_Fault:
-        cmCTestLog(this->CTest, HANDLER_OUTPUT, "SegFault");
         this->TestResult.Status = cmCTestTestHandler::SEGFAULT;
         break;
       case cmsysProcess_Exception_Illegal:
-        cmCTestLog(this->CTest, HANDLER_OUTPUT, "Illegal");
         this->TestResult.Status = cmCTestTestHandler::ILLEGAL;
         break;
       case cmsysProcess_Exception_Interrupt:
-        cmCTestLog(this->CTest, HANDLER_OUTPUT, "Interrupt");
         this->TestResult.Status = cmCTestTestHandler::INTERRUPT;
         break;
       case cmsysProcess_Exception_Numerical:
-        cmCTestLog(this->CTest, HANDLER_OUTPUT, "Numerical");
         this->TestResult.Status = cmCTestTestHandler::NUMERICAL;
         break;
       default:
-        cmCTestLog(this->CTest, HANDLER_OUTPUT, "Other");
         this->TestResult.Status = cmCTestTestHandler::OTHER_FAULT;
       }
     }
-  else //cmsysProcess_State_Error
-    {
-    cmCTestLog(this->CTest, HANDLER_OUTPUT, "***Not Run ");
-    }
+  // A test that did not start keeps the status StartTest gave it.
+  this->TestResult.Reason = reason;
 
   passed = this->TestResult.Status == cmCTestTestHandler::COMPLETED;
+  WriteResultLine(this->TestHandler, this->TestProperties, completed, total,
+                  this->TestResult, this->TestProcess->GetTotalTime(),
+                  this->ProcessOutput);
   char buf[1024];
   sprintf(buf, "%6.2f sec", this->TestProcess->GetTotalTime());
-  cmCTestLog(this->CTest, HANDLER_OUTPUT, buf << "\n" );
-
-  if ( outputTestErrorsToConsole )
-    {
-    cmCTestLog(this->CTest, HANDLER_OUTPUT, this->ProcessOutput << std::endl );
-    }
 
   if ( this->TestHandler->LogFile )
     {
@@ -273,7 +271,6 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
           this->TestHandler->CustomMaximumPassedTestOutputSize :
           this->TestHandler->CustomMaximumFailedTestOutputSize));
     }
-  this->TestResult.Reason = reason;
   if (this->TestHandler->LogFile)
     {
     bool pass = true;
@@ -329,7 +326,7 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
     this->TestResult.CompletionStatus = "Completed";
     this->TestResult.ExecutionTime = this->TestProcess->GetTotalTime();
     this->MemCheckPostProcess();
-    this->ComputeWeightedCost();
+    UpdateCost(this->TestProperties, this->TestResult);
     }
   // Always push the current TestResult onto the
   // TestHandler vector
@@ -339,16 +336,96 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
 }
 
 //----------------------------------------------------------------------
-void cmCTestRunTest::ComputeWeightedCost()
+void cmCTestRunTest::UpdateCost(
+  cmCTestTestHandler::cmCTestTestProperties* properties,
+  cmCTestTestHandler::cmCTestTestResult const& result)
 {
-  int prev = this->TestProperties->PreviousRuns;
-  float avgcost = this->TestProperties->Cost;
-  double current = this->TestResult.ExecutionTime;
+  int prev = properties->PreviousRuns;
+  float avgcost = properties->Cost;
+  double current = result.ExecutionTime;
+
+  if(result.Status == cmCTestTestHandler::COMPLETED)
+    {
+    properties->Cost = ((prev * avgcost) + current) / (prev + 1);
+    properties->PreviousRuns++;
+    }
+}
+
+//----------------------------------------------------------------------
+void cmCTestRunTest::WriteResultLine(
+  cmCTestTestHandler* handler,
+  cmCTestTestHandler::cmCTestTestProperties* properties,
+  size_t completed, size_t total,
+  cmCTestTestHandler::cmCTestTestResult const& result, double time,
+  std::string const& output)
+{
+  cmCTest* ctest = handler->CTest;
+  cmCTestLog(ctest, HANDLER_OUTPUT, std::setw(getNumWidth(total))
+             << completed << "/");
+  cmCTestLog(ctest, HANDLER_OUTPUT, std::setw(getNumWidth(total))
+             << total << " ");
+
+  if ( handler->MemCheck )
+    {
+    cmCTestLog(ctest, HANDLER_OUTPUT, "MemCheck");
+    }
+  else
+    {
+    cmCTestLog(ctest, HANDLER_OUTPUT, "Test");
+    }
+
+  cmOStringStream indexStr;
+  indexStr << " #" << properties->Index << ":";
+  cmCTestLog(ctest, HANDLER_OUTPUT,
+             std::setw(3 + getNumWidth(handler->GetMaxIndex()))
+             << indexStr.str().c_str());
+  cmCTestLog(ctest, HANDLER_OUTPUT, " ");
+  const int maxTestNameWidth = ctest->GetMaxTestNameWidth();
+  std::string outname = properties->Name + " ";
+  outname.resize(maxTestNameWidth + 4, '.');
+  cmCTestLog(ctest, HANDLER_OUTPUT, outname.c_str());
 
-  if(this->TestResult.Status == cmCTestTestHandler::COMPLETED)
+  bool outputTestErrorsToConsole = ctest->OutputTestOutputOnTestFailure;
+  switch ( result.Status )
     {
-    this->TestProperties->Cost = ((prev * avgcost) + current) / (prev + 1);
-    this->TestProperties->PreviousRuns++;
+    case cmCTestTestHandler::COMPLETED:
+      cmCTestLog(ctest, HANDLER_OUTPUT, "   Passed  " );
+      outputTestErrorsToConsole = false;
+      break;
+    case cmCTestTestHandler::FAILED:
+      cmCTestLog(ctest, HANDLER_OUTPUT, "***Failed  " << result.Reason );
+      break;
+    case cmCTestTestHandler::TIMEOUT:
+      cmCTestLog(ctest, HANDLER_OUTPUT, "***Timeout ");
+      break;
+    case cmCTestTestHandler::SEGFAULT:
+      cmCTestLog(ctest, HANDLER_OUTPUT, "***Exception: SegFault");
+      break;
+    case cmCTestTestHandler::ILLEGAL:
+      cmCTestLog(ctest, HANDLER_OUTPUT, "***Exception: Illegal");
+      break;
+    case cmCTestTestHandler::INTERRUPT:
+      cmCTestLog(ctest, HANDLER_OUTPUT, "***Exception: Interrupt");
+      break;
+    case cmCTestTestHandler::NUMERICAL:
+      cmCTestLog(ctest, HANDLER_OUTPUT, "***Exception: Numerical");
+      break;
+    case cmCTestTestHandler::OTHER_FAULT:
+      cmCTestLog(ctest, HANDLER_OUTPUT, "***Exception: Other");
+      break;
+    default:
+      cmCTestLog(ctest, HANDLER_OUTPUT, "***Not Run ");
+      outputTestErrorsToConsole = false;
+      break;
+    }
+
+  char buf[1024];
+  sprintf(buf, "%6.2f sec", time);
+  cmCTestLog(ctest, HANDLER_OUTPUT, buf << "\n" );
+
+  if ( outputTestErrorsToConsole )
+    {
+    cmCTestLog(ctest, HANDLER_OUTPUT, output << std::endl );
     }
 }
 
@@ -587,6 +664,18 @@ bool cmCTestRunTest::ForkProcess(double testTimeOut,
   this->TestProcess->SetCommand(this->ActualCommand.c_str());
   this->TestProcess->SetCommandArguments(this->Arguments);
 
+  // The standard input of a worker carries the commands of the
+  // coordinating ctest.  A test must neither read them nor wait for
+  // them to end.
+  if(this->CTest->GetWorkerId())
+    {
+#if defined(_WIN32) && !defined(__CYGWIN__)
+    this->TestProcess->SetInputFile("NUL");
+#else
+    this->TestProcess->SetInputFile("/dev/null");
+#endif
+    }
+
   // determine how much time we have
   double timeout = this->CTest->GetRemainingTimeAllowed() - 120;
   if (this->CTest->GetTimeOut() > 0 && this->CTest->GetTimeOut() < timeout)
@@ -621,32 +710,8 @@ bool cmCTestRunTest::ForkProcess(double testTimeOut,
   return this->TestProcess->StartProcess();
 }
 
-void cmCTestRunTest::WriteLogOutputTop(size_t completed, size_t total)
+void cmCTestRunTest::WriteLogOutputTop()
 {
-  cmCTestLog(this->CTest, HANDLER_OUTPUT, std::setw(getNumWidth(total))
-             << completed << "/");
-  cmCTestLog(this->CTest, HANDLER_OUTPUT, std::setw(getNumWidth(total))
-             << total << " ");
-
-  if ( this->TestHandler->MemCheck )
-    {
-    cmCTestLog(this->CTest, HANDLER_OUTPUT, "MemCheck");
-    }
-  else
-    {
-    cmCTestLog(this->CTest, HANDLER_OUTPUT, "Test");
-    }
-
-  cmOStringStream indexStr;
-  indexStr << " #" << this->Index << ":";
-  cmCTestLog(this->CTest, HANDLER_OUTPUT, 
-             std::setw(3 + getNumWidth(this->TestHandler->GetMaxIndex()))
-             << indexStr.str().c_str());
-  cmCTestLog(this->CTest, HANDLER_OUTPUT, " ");
-  const int maxTestNameWidth = this->CTest->GetMaxTestNameWidth();
-  std::string outname = this->TestProperties->Name + " ";
-  outname.resize(maxTestNameWidth + 4, '.');
-
   *this->TestHandler->LogFile << this->TestProperties->Index << "/"
     << this->TestHandler->TotalNumberOfTests << " Testing: " 
     << this->TestProperties->Name << std::endl;
@@ -673,7 +738,6 @@ void cmCTestRunTest::WriteLogOutputTop(size_t completed, size_t total)
   *this->TestHandler->LogFile
     << this->ProcessOutput.c_str() << "<end of output>" << std::endl;
 
-  cmCTestLog(this->CTest, HANDLER_OUTPUT, outname.c_str());
   cmCTestLog(this->CTest, DEBUG, "Testing " 
              << this->TestProperties->Name.c_str() << " ... ");
 }
@@ -42,8 +42,10 @@ public:
   cmCTestTestHandler::cmCTestTestResult GetTestResults()
   { return this->TestResult; }
 
-  // Read and store output.  Returns true if it must be called again.
-  bool CheckOutput();
+  // Read and store output for up to the given time, or only what is
+  // available now, for a short time at most, if it is zero.  Returns
+  // true if it must be called again.
+  bool CheckOutput(double timeout);
 
   // Compresses the output, writing to CompressedOutput
   void CompressOutput();
@@ -55,7 +57,20 @@ public:
   //Called by ctest -N to log the command string
   void ComputeArguments();
 
-  void ComputeWeightedCost();
+  // Fold the time of a passed test into the average cost of the test.
+  static void UpdateCost(cmCTestTestHandler::cmCTestTestProperties* p,
+                         cmCTestTestHandler::cmCTestTestResult const& r);
+
+  // Write the console line that reports the result of a test, followed
+  // by its output if it failed and --output-on-failure was given.  The
+  // coordinator of worker processes reports their tests with this too.
+  static void WriteResultLine(cmCTestTestHandler* handler,
+                              cmCTestTestHandler::cmCTestTestProperties* p,
+                              size_t completed, size_t total,
+                              cmCTestTestHandler::cmCTestTestResult const& r,
+                              double time, std::string const& output);
+
+  cmProcess* GetProcess() { return this->TestProcess; }
 private:
   void DartProcessing();
   void ExeNotFound(std::string exe);
@@ -63,7 +78,7 @@ private:
   double ResolveTimeout();
   bool ForkProcess(double testTimeOut,
                      std::vector<std::string>* environment);
-  void WriteLogOutputTop(size_t completed, size_t total);
+  void WriteLogOutputTop();
   //Run post processing of the process output for MemCheck
   void MemCheckPostProcess();
 
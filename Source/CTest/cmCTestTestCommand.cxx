@@ -25,6 +25,9 @@ cmCTestTestCommand::cmCTestTestCommand()
   this->Arguments[ctt_INCLUDE_LABEL] = "INCLUDE_LABEL";
   this->Arguments[ctt_PARALLEL_LEVEL] = "PARALLEL_LEVEL";
   this->Arguments[ctt_SCHEDULE_RANDOM] = "SCHEDULE_RANDOM";
+  this->Arguments[ctt_SCHEDULE_CRITICAL_PATH] = "SCHEDULE_CRITICAL_PATH";
+  this->Arguments[ctt_WORKERS] = "WORKERS";
+  this->Arguments[ctt_SHARD] = "SHARD";
   this->Arguments[ctt_STOP_TIME] = "STOP_TIME";
   this->Arguments[ctt_LAST] = 0;
   this->Last = ctt_LAST;
@@ -99,6 +102,19 @@ cmCTestGenericHandler* cmCTestTestCommand::InitializeHandler()
     handler->SetOption("ScheduleRandom",
                        this->Values[ctt_SCHEDULE_RANDOM]);
     }
+  if(this->Values[ctt_SCHEDULE_CRITICAL_PATH])
+    {
+    handler->SetOption("ScheduleCriticalPath",
+                       this->Values[ctt_SCHEDULE_CRITICAL_PATH]);
+    }
+  if(this->Values[ctt_WORKERS])
+    {
+    handler->SetOption("Workers", this->Values[ctt_WORKERS]);
+    }
+  if(this->Values[ctt_SHARD])
+    {
+    handler->SetOption("Shard", this->Values[ctt_SHARD]);
+    }
   if(this->Values[ctt_STOP_TIME])
     {
     this->CTest->SetStopTime(this->Values[ctt_STOP_TIME]);
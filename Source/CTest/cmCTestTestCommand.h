@@ -63,6 +63,9 @@ public:
       "             [INCLUDE_LABEL label regex] \n"
       "             [PARALLEL_LEVEL level] \n"
       "             [SCHEDULE_RANDOM on] \n"
+      "             [SCHEDULE_CRITICAL_PATH on] \n"
+      "             [WORKERS count] \n"
+      "             [SHARD k/n] \n"
       "             [STOP_TIME time of day]) \n"
       "Tests the given build directory and stores results in Test.xml. The "
       "second argument is a variable that will hold value. Optionally, "
@@ -74,7 +77,12 @@ public:
       "property LABEL. PARALLEL_LEVEL should be set to a positive number "
       "representing the number of tests to be run in parallel. "
       "SCHEDULE_RANDOM will launch tests in a random order, and is "
-      "typically used to detect implicit test dependencies. STOP_TIME is the "
+      "typically used to detect implicit test dependencies. "
+      "SCHEDULE_CRITICAL_PATH will launch tests on the longest chains of "
+      "dependent tests first, using the recorded test costs. WORKERS runs "
+      "the tests in the given number of worker ctest processes, like the "
+      "ctest --workers option. SHARD runs only the k-th of n sets of tests "
+      "balanced by cost, like the ctest --shard option. STOP_TIME is the "
       "time of day at which the tests should all stop running."
       "\n"
       CTEST_COMMAND_APPEND_OPTION_DOCS;
@@ -98,6 +106,9 @@ protected:
     ctt_INCLUDE_LABEL,
     ctt_PARALLEL_LEVEL,
     ctt_SCHEDULE_RANDOM,
+    ctt_SCHEDULE_CRITICAL_PATH,
+    ctt_WORKERS,
+    ctt_SHARD,
     ctt_STOP_TIME,
     ctt_LAST
   };
@@ -13,6 +13,8 @@
 #include "cmCTestTestHandler.h"
 #include "cmCTestMultiProcessHandler.h"
 #include "cmCTestBatchTestHandler.h"
+#include "cmCTestCoordinatorHandler.h"
+#include "cmCTestWorkerHandler.h"
 #include "cmCTest.h"
 #include "cmCTestRunTest.h"
 #include "cmake.h"
@@ -505,10 +507,23 @@ int cmCTestTestHandler::ProcessHandler()
     {
     this->CTest->SetScheduleType("Random");
     }
+  if(cmSystemTools::IsOn(this->GetOption("ScheduleCriticalPath")))
+    {
+    this->CTest->SetScheduleType("CriticalPath");
+    }
   if(this->GetOption("ParallelLevel"))
     {
     this->CTest->SetParallelLevel(atoi(this->GetOption("ParallelLevel")));
     }
+  if(this->GetOption("Workers"))
+    {
+    this->CTest->SetWorkers(atoi(this->GetOption("Workers")));
+    }
+  if(this->GetOption("Shard") &&
+     !this->CTest->SetShard(this->GetOption("Shard")))
+    {
+    return -1;
+    }
 
   const char* val;
   val = this->GetOption("LabelRegularExpression");
@@ -542,13 +557,25 @@ int cmCTestTestHandler::ProcessHandler()
              (this->MemCheck ? "Memory check" : "Test")
              << " project " << cmSystemTools::GetCurrentWorkingDirectory()
              << std::endl);
-  if ( ! this->PreProcessHandler() )
+  // A worker only runs tests for its coordinator, which does the rest.
+  int worker = this->CTest->GetWorkerId();
+  if ( !worker && ! this->PreProcessHandler() )
     {
     return -1;
     }
 
   cmGeneratedFileStream mLogFile;
-  this->StartLogFile((this->MemCheck ? "DynamicAnalysis" : "Test"), mLogFile);
+  if(worker)
+    {
+    cmOStringStream logName;
+    logName << "TestWorker" << worker;
+    this->StartLogFile(logName.str().c_str(), mLogFile);
+    }
+  else
+    {
+    this->StartLogFile((this->MemCheck ? "DynamicAnalysis" : "Test"),
+                       mLogFile);
+    }
   this->LogFile = &mLogFile;
 
   std::vector<cmStdString> passed;
@@ -563,6 +590,12 @@ int cmCTestTestHandler::ProcessHandler()
 
   clock_finish = cmSystemTools::GetTime();
 
+  if(worker)
+    {
+    this->LogFile = 0;
+    return 0;
+    }
+
   total = int(passed.size()) + int(failed.size());
 
   if (total == 0)
@@ -1020,8 +1053,25 @@ void cmCTestTestHandler::ProcessDirectory(std::vector<cmStdString> &passed,
   this->StartTestTime = static_cast<unsigned int>(cmSystemTools::GetTime());
   double elapsed_time_start = cmSystemTools::GetTime();
 
-  cmCTestMultiProcessHandler* parallel = this->CTest->GetBatchJobs() ?
-    new cmCTestBatchTestHandler : new cmCTestMultiProcessHandler;
+  cmCTestMultiProcessHandler* parallel;
+  if(this->CTest->GetWorkerId())
+    {
+    parallel = new cmCTestWorkerHandler;
+    }
+  else if(this->CTest->GetWorkers() > 0 && !this->MemCheck)
+    {
+    cmCTestCoordinatorHandler* coordinator = new cmCTestCoordinatorHandler;
+    coordinator->SetWorkers(this->CTest->GetWorkers());
+    parallel = coordinator;
+    }
+  else if(this->CTest->GetBatchJobs())
+    {
+    parallel = new cmCTestBatchTestHandler;
+    }
+  else
+    {
+    parallel = new cmCTestMultiProcessHandler;
+    }
   parallel->SetCTest(this->CTest);
   parallel->SetParallelLevel(this->CTest->GetParallelLevel());
   parallel->SetTestHandler(this);
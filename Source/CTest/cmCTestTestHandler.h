@@ -28,6 +28,8 @@ class cmCTestTestHandler : public cmCTestGenericHandler
   friend class cmCTestRunTest;
   friend class cmCTestMultiProcessHandler;
   friend class cmCTestBatchTestHandler;
+  friend class cmCTestWorkerHandler;
+  friend class cmCTestCoordinatorHandler;
 public:
   cmTypeMacro(cmCTestTestHandler, cmCTestGenericHandler);
 
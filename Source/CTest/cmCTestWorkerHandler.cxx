@@ -0,0 +1,226 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmCTestWorkerHandler.h"
+#include "cmCTestRunTest.h"
+#include "cmCTest.h"
+#include "cmSystemTools.h"
+#include <stdlib.h>
+
+//---------------------------------------------------------
+// Record values are written one per line with line breaks escaped.
+static std::string cmCTestWorkerEscape(std::string const& in)
+{
+  std::string out;
+  out.reserve(in.size());
+  for(std::string::const_iterator c = in.begin(); c != in.end(); ++c)
+    {
+    switch(*c)
+      {
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\0': out += "\\0"; break;
+      default: out += *c; break;
+      }
+    }
+  return out;
+}
+
+//---------------------------------------------------------
+static std::string cmCTestWorkerUnescape(std::string const& in)
+{
+  std::string out;
+  out.reserve(in.size());
+  for(std::string::const_iterator c = in.begin(); c != in.end(); ++c)
+    {
+    if(*c == '\\' && c + 1 != in.end())
+      {
+      ++c;
+      switch(*c)
+        {
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case '0': out += '\0'; break;
+        default: out += *c; break;
+        }
+      }
+    else
+      {
+      out += *c;
+      }
+    }
+  return out;
+}
+
+//---------------------------------------------------------
+void cmCTestWorkerHandler::RunTests()
+{
+  std::string line;
+  while(std::getline(std::cin, line))
+    {
+    Record r;
+    r.Index = atoi(line.c_str());
+    if(this->Properties.find(r.Index) != this->Properties.end())
+      {
+      this->RunTest(r);
+      }
+    else
+      {
+      r.Result.Output = "Test " + line + " is not known to the worker";
+      }
+    // Log output goes to stderr, leaving stdout for the results.
+#ifdef cout
+#  undef cout
+#endif
+    WriteRecord(std::cout, r);
+    std::cout.flush();
+#define cout no_cout_use_cmCTestLog
+    }
+}
+
+//---------------------------------------------------------
+void cmCTestWorkerHandler::RunTest(Record& r)
+{
+  int test = r.Index;
+
+  // Collect the test log for the coordinator to put in its own log.
+  std::ostream* logFile = this->TestHandler->LogFile;
+  cmOStringStream testLog;
+  this->TestHandler->LogFile = &testLog;
+  this->TestHandler->TestResults.clear();
+
+  std::string current_dir = cmSystemTools::GetCurrentWorkingDirectory();
+  cmSystemTools::ChangeDirectory(this->Properties[test]->Directory.c_str());
+
+  cmCTestRunTest testRun(this->TestHandler);
+  testRun.SetIndex(test);
+  testRun.SetTestProperties(this->Properties[test]);
+  bool started = testRun.StartTest(this->Total);
+  if(started)
+    {
+    while(testRun.CheckOutput(1))
+      {
+      }
+    }
+  this->Completed++;
+  bool passed = testRun.EndTest(this->Completed, this->Total, started);
+
+  cmSystemTools::ChangeDirectory(current_dir.c_str());
+  this->TestHandler->LogFile = logFile;
+
+  r.Result = this->TestHandler->TestResults.back();
+  this->TestHandler->TestResults.clear();
+  r.Log = testLog.str();
+  if(!passed)
+    {
+    r.FailureOutput = testRun.GetProcessOutput();
+    }
+}
+
+//---------------------------------------------------------
+void cmCTestWorkerHandler::WriteRecord(std::ostream& os, Record const& r)
+{
+  cmCTestTestHandler::cmCTestTestResult const& res = r.Result;
+  char time[100];
+  sprintf(time, "%.6f", res.ExecutionTime);
+  os << "@result " << r.Index << "\n"
+     << "@status " << res.Status << "\n"
+     << "@return " << res.ReturnValue << "\n"
+     << "@time " << time << "\n"
+     << "@compress " << (res.CompressOutput? 1 : 0) << "\n"
+     << "@completion " << cmCTestWorkerEscape(res.CompletionStatus) << "\n"
+     << "@reason " << cmCTestWorkerEscape(res.Reason) << "\n"
+     << "@command " << cmCTestWorkerEscape(res.FullCommandLine) << "\n"
+     << "@output " << cmCTestWorkerEscape(res.Output) << "\n"
+     << "@images " << cmCTestWorkerEscape(res.RegressionImages) << "\n"
+     << "@log " << cmCTestWorkerEscape(r.Log) << "\n"
+     << "@failure " << cmCTestWorkerEscape(r.FailureOutput) << "\n"
+     << "@end\n";
+}
+
+//---------------------------------------------------------
+bool cmCTestWorkerHandler::ReadRecordLine(std::string const& line,
+                                          Record& r, bool& consumed)
+{
+  consumed = false;
+  if(line.empty() || line[0] != '@')
+    {
+    return false;
+    }
+  std::string::size_type pos = line.find(' ');
+  std::string key = line.substr(0, pos);
+  std::string value;
+  if(pos != std::string::npos)
+    {
+    value = cmCTestWorkerUnescape(line.substr(pos + 1));
+    }
+  cmCTestTestHandler::cmCTestTestResult& res = r.Result;
+  consumed = true;
+  if(key == "@result")
+    {
+    r = Record();
+    r.Index = atoi(value.c_str());
+    }
+  else if(key == "@status")
+    {
+    res.Status = atoi(value.c_str());
+    }
+  else if(key == "@return")
+    {
+    res.ReturnValue = atoi(value.c_str());
+    }
+  else if(key == "@time")
+    {
+    res.ExecutionTime = atof(value.c_str());
+    }
+  else if(key == "@compress")
+    {
+    res.CompressOutput = value == "1";
+    }
+  else if(key == "@completion")
+    {
+    res.CompletionStatus = value;
+    }
+  else if(key == "@reason")
+    {
+    res.Reason = value;
+    }
+  else if(key == "@command")
+    {
+    res.FullCommandLine = value;
+    }
+  else if(key == "@output")
+    {
+    res.Output = value;
+    }
+  else if(key == "@images")
+    {
+    res.RegressionImages = value;
+    }
+  else if(key == "@log")
+    {
+    r.Log = value;
+    }
+  else if(key == "@failure")
+    {
+    r.FailureOutput = value;
+    }
+  else if(key == "@end")
+    {
+    return true;
+    }
+  else
+    {
+    consumed = false;
+    }
+  return false;
+}
@@ -0,0 +1,63 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmCTestWorkerHandler_h
+#define cmCTestWorkerHandler_h
+
+#include <cmStandardIncludes.h>
+#include <cmCTestTestHandler.h>
+#include <cmCTestMultiProcessHandler.h>
+
+/** \class cmCTestWorkerHandler
+ * \brief run tests on behalf of a coordinating ctest
+ *
+ * cmCTestWorkerHandler reads test numbers from standard input, one per
+ * line, runs each test and writes its result to standard output as a
+ * record that cmCTestCoordinatorHandler reads back.
+ */
+class cmCTestWorkerHandler : public cmCTestMultiProcessHandler
+{
+public:
+  virtual void RunTests();
+
+  // The result of one test as sent from a worker to the coordinator.
+  struct Record
+  {
+    Record(): Index(0)
+      {
+      this->Result.ExecutionTime = 0;
+      this->Result.ReturnValue = -1;
+      this->Result.Status = cmCTestTestHandler::NOT_RUN;
+      this->Result.CompressOutput = false;
+      this->Result.CompletionStatus = "Not Run";
+      this->Result.TestCount = 0;
+      this->Result.Properties = 0;
+      }
+    int Index;
+    cmCTestTestHandler::cmCTestTestResult Result;
+    // The test section of the worker's test log
+    std::string Log;
+    // The test output if it did not pass, for --output-on-failure
+    std::string FailureOutput;
+  };
+
+  static void WriteRecord(std::ostream& os, Record const& r);
+
+  // Parse one line of a record written by WriteRecord.  Returns true
+  // when the line completes the record.  Lines that are not part of
+  // a record are not consumed and false is returned.
+  static bool ReadRecordLine(std::string const& line, Record& r,
+                             bool& consumed);
+protected:
+  void RunTest(Record& r);
+};
+
+#endif
@@ -13,6 +13,13 @@
 #include <cmProcess.h>
 #include <cmSystemTools.h>
 
+#if !defined(_WIN32) || defined(__CYGWIN__)
+# include <poll.h>
+# include <errno.h>
+# include <signal.h>
+# include <unistd.h>
+#endif
+
 cmProcess::cmProcess()
 {
   this->Process = 0;
@@ -21,10 +28,13 @@ cmProcess::cmProcess()
   this->ExitValue = 0;
   this->Id = 0;
   this->StartTime = 0;
+  this->InputPipe[0] = -1;
+  this->InputPipe[1] = -1;
 }
 
 cmProcess::~cmProcess()
 {
+  this->CloseInputPipe();
   cmsysProcess_Delete(this->Process);
 }
 void cmProcess::SetCommand(const char* command)
@@ -62,11 +72,85 @@ bool cmProcess::StartProcess()
                                      this->WorkingDirectory.c_str());
     }
   cmsysProcess_SetTimeout(this->Process, this->Timeout);
+  if(!this->InputFile.empty())
+    {
+    cmsysProcess_SetPipeFile(this->Process, cmsysProcess_Pipe_STDIN,
+                             this->InputFile.c_str());
+    }
+#if !defined(_WIN32) || defined(__CYGWIN__)
+  if(this->InputPipe[0] >= 0)
+    {
+    // The read end is closed in this process once the child has it.
+    cmsysProcess_SetPipeNative(this->Process, cmsysProcess_Pipe_STDIN,
+                               this->InputPipe);
+    this->InputPipe[0] = -1;
+    }
+#endif
   cmsysProcess_Execute(this->Process);
   return (cmsysProcess_GetState(this->Process)
           == cmsysProcess_State_Executing);
 }
 
+//----------------------------------------------------------------------------
+bool cmProcess::OpenInputPipe()
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  return false;
+#else
+  this->CloseInputPipe();
+  return pipe(this->InputPipe) == 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool cmProcess::WriteInput(std::string const& data)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  (void)data;
+  return false;
+#else
+  if(this->InputPipe[1] < 0)
+    {
+    return false;
+    }
+  // Report a process that has exited instead of dying of SIGPIPE.
+  void (*handler)(int) = signal(SIGPIPE, SIG_IGN);
+  const char* p = data.c_str();
+  size_t left = data.size();
+  while(left > 0)
+    {
+    ssize_t n = write(this->InputPipe[1], p, left);
+    if(n < 0 && errno == EINTR)
+      {
+      continue;
+      }
+    if(n <= 0)
+      {
+      break;
+      }
+    p += n;
+    left -= n;
+    }
+  signal(SIGPIPE, handler);
+  return left == 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void cmProcess::CloseInputPipe()
+{
+#if !defined(_WIN32) || defined(__CYGWIN__)
+  for(int i = 0; i < 2; ++i)
+    {
+    if(this->InputPipe[i] >= 0)
+      {
+      close(this->InputPipe[i]);
+      this->InputPipe[i] = -1;
+      }
+    }
+#endif
+}
+
 //----------------------------------------------------------------------------
 bool cmProcess::Buffer::GetLine(std::string& line)
 {
@@ -264,3 +348,67 @@ int cmProcess::ReportStatus()
   return result;
 
 }
+
+bool cmProcess::WaitForAny(std::vector<cmProcess*> const& procs)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  (void)procs;
+  return false;
+#else
+  std::vector<struct pollfd> fds;
+  double now = cmSystemTools::GetTime();
+  double timeout = -1;
+  for(std::vector<cmProcess*>::const_iterator i = procs.begin();
+      i != procs.end(); ++i)
+    {
+    cmProcess* p = *i;
+
+    // Lines read from the pipes earlier may still be waiting.
+    if(p->StdOut.HasUnscanned() || p->StdErr.HasUnscanned())
+      {
+      return true;
+      }
+
+    cmsysProcess_Pipe_Handle handles[8];
+    int n = cmsysProcess_GetPipeHandles(p->Process, handles, 8);
+    if(n < 0)
+      {
+      return false;
+      }
+    else if(n == 0)
+      {
+      return true;
+      }
+    for(int h = 0; h < n; ++h)
+      {
+      struct pollfd fd;
+      fd.fd = handles[h];
+      fd.events = POLLIN;
+      fd.revents = 0;
+      fds.push_back(fd);
+      }
+
+    // Wake up in time to let the process timeout expire.
+    if(p->Timeout > 0)
+      {
+      double left = p->StartTime + p->Timeout - now;
+      if(timeout < 0 || left < timeout)
+        {
+        timeout = left > 0? left : 0;
+        }
+      }
+    }
+  if(fds.empty())
+    {
+    return true;
+    }
+
+  // Round up to at least one millisecond so that a process timeout
+  // is not polled for in a busy loop.
+  int ms = timeout < 0? -1 : static_cast<int>(timeout * 1000) + 1;
+  while(poll(&*fds.begin(), fds.size(), ms) < 0 && errno == EINTR)
+    {
+    }
+  return true;
+#endif
+}
@@ -32,6 +32,16 @@ public:
   void SetCommandArguments(std::vector<std::string> const& arg);
   void SetWorkingDirectory(const char* dir) { this->WorkingDirectory = dir;}
   void SetTimeout(double t) { this->Timeout = t;}
+  // Give the process a pipe on its standard input.  Call before
+  // StartProcess.  Returns false if this is not supported.
+  bool OpenInputPipe();
+  // Write to the input pipe.  Returns false if the process is gone.
+  bool WriteInput(std::string const& data);
+  // Close the input pipe so that the process reads end of file.
+  void CloseInputPipe();
+  // Give the process the named file on its standard input instead of
+  // sharing ours.  Call before StartProcess.
+  void SetInputFile(const char* file) { this->InputFile = file; }
   // Return true if the process starts
   bool StartProcess();
 
@@ -53,6 +63,14 @@ public:
    *   cmsysProcess_Pipe_Timeout = Timeout expired while waiting
    */
   int GetNextOutputLine(std::string& line, double timeout);
+
+  /**
+   * Block until one of the given processes has output to read, has
+   * terminated, or has reached its timeout.  GetNextOutputLine may then
+   * be called on each of them with a zero timeout.  Returns false
+   * without waiting if this is not supported on the platform.
+   */
+  static bool WaitForAny(std::vector<cmProcess*> const& procs);
 private:
   double Timeout;
   double StartTime;
@@ -67,6 +85,7 @@ private:
     Buffer(): First(0), Last(0) {}
     bool GetLine(std::string& line);
     bool GetLast(std::string& line);
+    bool HasUnscanned() const { return this->Last != this->size(); }
   };
   Buffer StdErr;
   Buffer StdOut;
@@ -74,6 +93,8 @@ private:
   std::string WorkingDirectory;
   std::vector<std::string> Arguments;
   std::vector<const char*> ProcessArgs;
+  int InputPipe[2];
+  std::string InputFile;
   std::string Output;
   int Id;
   int ExitValue;
@@ -42,6 +42,11 @@ public:
    */
   virtual bool IsScriptable() { return true; }
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() { return true; }
+
   /**
    * The name of the command as specified in CMakeList.txt.
    */
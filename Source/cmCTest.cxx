@@ -292,6 +292,10 @@ cmCTest::cmCTest()
   this->SubmitIndex            = 0;
   this->Failover               = false;
   this->BatchJobs              = false;
+  this->Workers                = 0;
+  this->WorkerId               = 0;
+  this->ShardIndex             = 1;
+  this->ShardCount             = 1;
   this->ForceNewCTestProcess   = false;
   this->TomorrowTag            = false;
   this->Verbose                = false;
@@ -1928,6 +1932,30 @@ void cmCTest::HandleCommandLineArguments(size_t &i,
     {
     this->BatchJobs = true;
     }
+  if(this->CheckArgument(arg, "--workers") && i < args.size() - 1)
+    {
+    i++;
+    this->Workers = atoi(args[i].c_str());
+    }
+  if(this->CheckArgument(arg, "--worker-launcher") && i < args.size() - 1)
+    {
+    i++;
+    this->WorkerLauncher = args[i];
+    }
+  if(this->CheckArgument(arg, "--worker") && i < args.size() - 1)
+    {
+    i++;
+    this->WorkerId = atoi(args[i].c_str());
+    // The coordinator reads test results from our stdout.
+#ifdef cerr
+#  undef cerr
+#endif
+    this->SetStreams(&std::cerr, &std::cerr);
+#define cerr no_cerr_use_cmCTestLog
+    // The coordinator passes --no-compress-output if it does not want
+    // compressed output, so there is no need to ask the dashboard.
+    this->ComputedCompressOutput = true;
+    }
   if(this->CheckArgument(arg, "-VV", "--extra-verbose"))
     {
     this->ExtraVerbose = true;
@@ -2206,6 +2234,20 @@ int cmCTest::Run(std::vector<std::string> &args, std::string* output)
       this->ScheduleType = "Random";
       }
 
+    if(this->CheckArgument(arg, "--schedule-critical-path"))
+      {
+      this->ScheduleType = "CriticalPath";
+      }
+
+    if(this->CheckArgument(arg, "--shard") && i < args.size() - 1)
+      {
+      i++;
+      if(!this->SetShard(args[i]))
+        {
+        performSomeTest = false;
+        }
+      }
+
     // pass the argument to all the handlers as well, but i may no longer be
     // set to what it was originally so I'm not sure this is working as
     // intended
@@ -2310,6 +2352,24 @@ int cmCTest::Run(std::vector<std::string> &args, std::string* output)
   return 1;
 }
 
+//----------------------------------------------------------------------
+bool cmCTest::SetShard(std::string const& shard)
+{
+  int index = 0;
+  int count = 0;
+  char extra;
+  if(sscanf(shard.c_str(), "%d/%d%c", &index, &count, &extra) != 2 ||
+     index < 1 || index > count)
+    {
+    cmCTestLog(this, ERROR_MESSAGE, "Invalid shard \"" << shard
+               << "\".  Expected K/N with 1 <= K <= N." << std::endl);
+    return false;
+    }
+  this->ShardIndex = index;
+  this->ShardCount = count;
+  return true;
+}
+
 //----------------------------------------------------------------------
 void cmCTest::FindRunningCMake()
 {
@@ -47,6 +47,7 @@ class cmCTest
 {
   friend class cmCTestRunTest;
   friend class cmCTestMultiProcessHandler;
+  friend class cmCTestCoordinatorHandler;
 public:
   /** Enumerate parts of the testing and submission process.  */
   enum Part
@@ -393,6 +394,22 @@ public:
   void SetBatchJobs(bool batch = true) { this->BatchJobs = batch; }
   bool GetBatchJobs() { return this->BatchJobs; }
 
+  /** Number of worker ctest processes to run the tests in, or 0 to run
+      them from this process.  */
+  int GetWorkers() { return this->Workers; }
+  void SetWorkers(int workers) { this->Workers = workers; }
+  /** Command line prefix used to launch each worker process.  */
+  std::string const& GetWorkerLauncher() { return this->WorkerLauncher; }
+  /** Number of this process among the workers of a coordinating ctest,
+      starting at 1, or 0 if this is not a worker.  */
+  int GetWorkerId() { return this->WorkerId; }
+
+  /** Run only shard K of N given as "K/N", counting from 1.  Returns
+      false if the value is not valid.  */
+  bool SetShard(std::string const& shard);
+  int GetShardIndex() { return this->ShardIndex; }
+  int GetShardCount() { return this->ShardCount; }
+
   bool GetVerbose() { return this->Verbose;}
   bool GetExtraVerbose() { return this->ExtraVerbose;}
 
@@ -415,6 +432,11 @@ private:
   bool UseHTTP10;
   bool Failover;
   bool BatchJobs;
+  int Workers;
+  int WorkerId;
+  std::string WorkerLauncher;
+  int ShardIndex;
+  int ShardCount;
 
   bool ForceNewCTestProcess;
 
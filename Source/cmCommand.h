@@ -36,7 +36,7 @@ public:
    * Construct the command. By default it is enabled with no makefile.
    */
   cmCommand()  
-    {this->Makefile = 0; this->Enabled = true;}
+    {this->Makefile = 0; this->Enabled = true; this->Invoking = false;}
 
   /**
    * Need virtual destructor to destroy real command type.
@@ -101,6 +101,24 @@ public:
     return false;
     }
 
+  /**
+   * This determines if the command may be invoked on the registered
+   * prototype instead of on a clone.  Such a command must keep no
+   * state between invocations other than its makefile and error and
+   * must not have a final pass.
+   */
+  virtual bool IsStateless()
+    {
+    return false;
+    }
+
+  /**
+   * Mark whether this instance is currently being invoked.  Used to
+   * avoid re-entering a stateless prototype.
+   */
+  bool GetInvoking() const { return this->Invoking; }
+  void SetInvoking(bool b) { this->Invoking = b; }
+
   /**
    * This determines if usage of the method is discouraged or not.
    * This is currently only used for generating the documentation.
@@ -162,6 +180,14 @@ public:
       return this->Error.c_str();
     }
 
+  /**
+   * Forget the error from a previous invocation.
+   */
+  void ClearError()
+    {
+    this->Error = "";
+    }
+
   /**
    * Set the error message
    */
@@ -178,6 +204,7 @@ protected:
 
 private:
   bool Enabled;
+  bool Invoking;
   std::string Error;
 };
 
@@ -0,0 +1,307 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmCommandArgumentExpander.h"
+
+#include "cmMakefile.h"
+#include "cmSystemTools.h"
+
+//----------------------------------------------------------------------------
+static bool cmCommandArgumentExpanderIsNameChar(char c)
+{
+  // Same set as the [A-Za-z0-9/_.+-] class in the lexer.
+  return ((c >= 'A' && c <= 'Z') ||
+          (c >= 'a' && c <= 'z') ||
+          (c >= '0' && c <= '9') ||
+          c == '/' || c == '_' || c == '.' || c == '+' || c == '-');
+}
+
+//----------------------------------------------------------------------------
+static const char* cmCommandArgumentExpanderSkipName(const char* s,
+                                                     const char* end)
+{
+  while(s != end && cmCommandArgumentExpanderIsNameChar(*s))
+    {
+    ++s;
+    }
+  return s;
+}
+
+//----------------------------------------------------------------------------
+cmCommandArgumentExpander::cmCommandArgumentExpander(const cmMakefile* mf):
+  Makefile(mf)
+{
+  this->FileLine = -1;
+  this->EscapeQuotes = false;
+  this->NoEscapeMode = false;
+  this->ReplaceAtSyntax = false;
+  this->RemoveEmpty = true;
+}
+
+//----------------------------------------------------------------------------
+bool cmCommandArgumentExpander::Expand(std::string const& in,
+                                       std::string& out)
+{
+  // Check the whole string before looking up any variable so that
+  // rejected input is not seen twice by variable watches.
+  if(!this->Process(in, 0))
+    {
+    return false;
+    }
+  out = "";
+  return this->Process(in, &out);
+}
+
+//----------------------------------------------------------------------------
+bool cmCommandArgumentExpander::Process(std::string const& in,
+                                        std::string* out)
+{
+  this->Stack.clear();
+  const char* s = in.c_str();
+  const char* end = s + in.size();
+  while(s != end)
+    {
+    // Text goes to the name of the innermost open reference, if any.
+    Frame* top = this->Stack.empty()? 0 : &this->Stack.back();
+    std::string* dest = out;
+    if(out && top)
+      {
+      dest = &top->Name;
+      }
+
+    if(*s == '$')
+      {
+      const char* n = cmCommandArgumentExpanderSkipName(s+1, end);
+      if(n != end && *n == '{')
+        {
+        // Only ${ and $ENV{ are handled here.  Leave $CACHE{ and the
+        // error for unknown keys to the parser.
+        bool env = false;
+        if(n != s+1)
+          {
+          if(n-s-1 != 3 || strncmp(s+1, "ENV", 3) != 0)
+            {
+            return false;
+            }
+          env = true;
+          }
+        Frame f;
+        f.Env = env;
+        f.HasName = false;
+        this->Stack.push_back(f);
+        s = n+1;
+        continue;
+        }
+      if(top)
+        {
+        return false;
+        }
+      if(dest)
+        {
+        dest->append(1, '$');
+        }
+      ++s;
+      }
+    else if(*s == '@')
+      {
+      const char* n = cmCommandArgumentExpanderSkipName(s+1, end);
+      if(n != s+1 && n != end && *n == '@')
+        {
+        if(top)
+          {
+          top->HasName = true;
+          }
+        if(dest)
+          {
+          this->AppendAtVariable(*dest, std::string(s+1, n));
+          }
+        s = n+1;
+        continue;
+        }
+      if(top)
+        {
+        return false;
+        }
+      if(dest)
+        {
+        dest->append(1, '@');
+        }
+      ++s;
+      }
+    else if(*s == '}')
+      {
+      ++s;
+      if(!top)
+        {
+        if(dest)
+          {
+          dest->append(1, '}');
+          }
+        continue;
+        }
+      if(!out)
+        {
+        this->Stack.pop_back();
+        continue;
+        }
+
+      // Close the reference and expand it into the enclosing text.
+      bool env = top->Env;
+      bool hasName = top->HasName;
+      std::string name;
+      name.swap(top->Name);
+      this->Stack.pop_back();
+      Frame* outer = this->Stack.empty()? 0 : &this->Stack.back();
+      dest = outer? &outer->Name : out;
+      bool defined = false;
+      if(env)
+        {
+        defined = true;
+        if(hasName)
+          {
+          if(const char* value = getenv(name.c_str()))
+            {
+            this->AppendValue(*dest, value);
+            }
+          }
+        }
+      else if(hasName)
+        {
+        defined = this->AppendVariable(*dest, name.c_str());
+        }
+      if(outer && defined)
+        {
+        outer->HasName = true;
+        }
+      }
+    else if(*s == '\\')
+      {
+      if(top || (!this->NoEscapeMode && s+1 == end))
+        {
+        return false;
+        }
+      if(this->NoEscapeMode)
+        {
+        if(dest)
+          {
+          dest->append(1, '\\');
+          }
+        ++s;
+        continue;
+        }
+      const char* value;
+      switch(s[1])
+        {
+        case '\\': value = "\\"; break;
+        case '"': value = "\""; break;
+        case ' ': value = " "; break;
+        case '#': value = "#"; break;
+        case '(': value = "("; break;
+        case ')': value = ")"; break;
+        case '$': value = "$"; break;
+        case '@': value = "@"; break;
+        case '^': value = "^"; break;
+        case ';': value = "\\;"; break;
+        case 't': value = "\t"; break;
+        case 'n': value = "\n"; break;
+        case 'r': value = "\r"; break;
+        case '0': value = ""; break;
+        default: return false;
+        }
+      if(dest)
+        {
+        dest->append(value);
+        }
+      s += 2;
+      }
+    else if(top)
+      {
+      // Only names and nested references may appear in a reference.
+      const char* n = cmCommandArgumentExpanderSkipName(s, end);
+      if(n == s || (n != end && *n != '$' && *n != '@' && *n != '}'))
+        {
+        return false;
+        }
+      top->HasName = true;
+      if(dest)
+        {
+        dest->append(s, n);
+        }
+      s = n;
+      }
+    else
+      {
+      // Copy plain text up to the next character with a meaning.
+      const char* n = s+1;
+      while(n != end && *n != '$' && *n != '@' && *n != '\\' && *n != '}')
+        {
+        ++n;
+        }
+      if(dest)
+        {
+        dest->append(s, n);
+        }
+      s = n;
+      }
+    }
+
+  // An unterminated reference is a syntax error.
+  return this->Stack.empty();
+}
+
+//----------------------------------------------------------------------------
+bool cmCommandArgumentExpander::AppendVariable(std::string& out,
+                                               const char* var)
+{
+  if(this->FileLine >= 0 && strcmp(var, "CMAKE_CURRENT_LIST_LINE") == 0)
+    {
+    cmOStringStream ostr;
+    ostr << this->FileLine;
+    out += ostr.str();
+    return true;
+    }
+  const char* value = this->Makefile->GetDefinition(var);
+  if(!value)
+    {
+    // An undefined variable expands to nothing unless the caller asked
+    // to keep the reference, in which case the result is null.
+    return this->RemoveEmpty;
+    }
+  this->AppendValue(out, value);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmCommandArgumentExpander::AppendAtVariable(std::string& out,
+                                                 std::string const& var)
+{
+  if(this->ReplaceAtSyntax && this->AppendVariable(out, var.c_str()))
+    {
+    return;
+    }
+  out += "@";
+  out += var;
+  out += "@";
+}
+
+//----------------------------------------------------------------------------
+void cmCommandArgumentExpander::AppendValue(std::string& out,
+                                            const char* value)
+{
+  if(this->EscapeQuotes)
+    {
+    out += cmSystemTools::EscapeQuotes(value);
+    }
+  else
+    {
+    out += value;
+    }
+}
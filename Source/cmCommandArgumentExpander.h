@@ -0,0 +1,67 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmCommandArgumentExpander_h
+#define cmCommandArgumentExpander_h
+
+#include "cmStandardIncludes.h"
+
+class cmMakefile;
+
+/** \class cmCommandArgumentExpander
+ * \brief Expand variable references in command arguments in one pass.
+ *
+ * This produces the same result as cmCommandArgumentParserHelper for
+ * ${VAR}, $ENV{VAR} and @VAR@ references, nested references and
+ * escape sequences without running the lexer and parser.  Strings
+ * that use other syntax or contain errors are rejected before any
+ * variable is looked up so the caller can fall back to the parser,
+ * which reports errors.
+ */
+class cmCommandArgumentExpander
+{
+public:
+  cmCommandArgumentExpander(const cmMakefile* mf);
+
+  void SetLineFile(long line) { this->FileLine = line; }
+  void SetEscapeQuotes(bool b) { this->EscapeQuotes = b; }
+  void SetNoEscapeMode(bool b) { this->NoEscapeMode = b; }
+  void SetReplaceAtSyntax(bool b) { this->ReplaceAtSyntax = b; }
+  void SetRemoveEmpty(bool b) { this->RemoveEmpty = b; }
+
+  /** Expand the input into the output.  Returns false, leaving the
+      output untouched, if the input must be given to the parser.  */
+  bool Expand(std::string const& in, std::string& out);
+
+private:
+  // A ${...} or $ENV{...} reference whose name is being collected.
+  struct Frame
+  {
+    bool Env;
+    bool HasName;
+    std::string Name;
+  };
+
+  bool Process(std::string const& in, std::string* out);
+  bool AppendVariable(std::string& out, const char* var);
+  void AppendAtVariable(std::string& out, std::string const& var);
+  void AppendValue(std::string& out, const char* value);
+
+  const cmMakefile* Makefile;
+  long FileLine;
+  bool EscapeQuotes;
+  bool NoEscapeMode;
+  bool ReplaceAtSyntax;
+  bool RemoveEmpty;
+  std::vector<Frame> Stack;
+};
+
+#endif
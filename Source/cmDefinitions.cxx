@@ -33,13 +33,15 @@ cmDefinitions::GetInternal(const char* key)
   MapType::const_iterator i = this->Map.find(key);
   if(i != this->Map.end())
     {
-    return i->second;
+    return i->second.Get();
     }
   else if(cmDefinitions* up = this->Up)
     {
-    // Query the parent scope and store the result locally.
-    Def def = up->GetInternal(key);
-    return this->Map.insert(MapType::value_type(key, def)).first->second;
+    // Query the parent scope and reference the result locally.  The
+    // parent cannot change while this scope exists.
+    Def const& def = up->GetInternal(key);
+    this->Map.insert(MapType::value_type(key, Entry(&def)));
+    return def;
     }
   return this->NoDef;
 }
@@ -54,13 +56,13 @@ cmDefinitions::SetInternal(const char* key, Def const& def)
     MapType::iterator i = this->Map.find(key);
     if(i == this->Map.end())
       {
-      i = this->Map.insert(MapType::value_type(key, def)).first;
+      i = this->Map.insert(MapType::value_type(key, Entry(def))).first;
       }
     else
       {
-      i->second = def;
+      i->second = Entry(def);
       }
-    return i->second;
+    return i->second.Value;
     }
   else
     {
@@ -110,9 +112,10 @@ void cmDefinitions::ClosureImpl(std::set<cmStdString>& undefined,
     if(this->Map.find(mi->first) == this->Map.end() &&
        undefined.find(mi->first) == undefined.end())
       {
-      if(mi->second.Exists)
+      Def const& def = mi->second.Get();
+      if(def.Exists)
         {
-        this->Map.insert(*mi);
+        this->Map.insert(MapType::value_type(mi->first, Entry(def)));
         }
       else
         {
@@ -149,7 +152,8 @@ void cmDefinitions::ClosureKeys(std::set<cmStdString>& defined,
     if(defined.find(mi->first) == defined.end() &&
        undefined.find(mi->first) == undefined.end())
       {
-      std::set<cmStdString>& m = mi->second.Exists? defined : undefined;
+      std::set<cmStdString>& m =
+        mi->second.Get().Exists? defined : undefined;
       m.insert(mi->first);
       }
     }
@@ -14,12 +14,18 @@
 
 #include "cmStandardIncludes.h"
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+# include <cmsys/hash_map.hxx>
+#endif
+
 /** \class cmDefinitions
  * \brief Store a scope of variable definitions for CMake language.
  *
  * This stores the state of variable definitions (set or unset) for
  * one scope.  Sets are always local.  Gets search parent scopes
- * transitively and save results locally.
+ * transitively and save a reference to the result locally.  A parent
+ * scope may not be modified while it has children except through the
+ * scope raising a value, which must first localize it with Set.
  */
 class cmDefinitions
 {
@@ -34,7 +40,8 @@ public:
   cmDefinitions* GetParent() const { return this->Up; }
 
   /** Get the value associated with a key; null if none.
-      Store the result locally if it came from a parent.  */
+      Store a reference to the result locally if it came from a
+      parent.  */
   const char* Get(const char* key);
 
   /** Set (or unset if null) a value associated with a key.  */
@@ -61,8 +68,33 @@ private:
   // Parent scope, if any.
   cmDefinitions* Up;
 
-  // Local definitions, set or unset.
-  typedef std::map<cmStdString, Def> MapType;
+  // Local definition, set or unset, or reference to a definition
+  // owned by a parent scope.
+  struct Entry
+  {
+    Entry(): Value(), Ref(0) {}
+    Entry(Def const& d): Value(d), Ref(0) {}
+    Entry(Def const* r): Value(), Ref(r) {}
+    Def const& Get() const { return this->Ref? *this->Ref : this->Value; }
+    Def Value;
+    Def const* Ref;
+  };
+
+  // Local entries.  The containers keep element addresses stable so
+  // child scopes may reference them.
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  struct HashString
+  {
+    size_t operator()(const cmStdString& s) const
+      {
+      return h(s.c_str());
+      }
+    cmsys::hash<const char*> h;
+  };
+  typedef cmsys::hash_map<cmStdString, Entry, HashString> MapType;
+#else
+  typedef std::map<cmStdString, Entry> MapType;
+#endif
   MapType Map;
 
   // Internal query and update methods.
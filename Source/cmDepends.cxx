@@ -18,11 +18,44 @@
 #include "cmFileTimeComparison.h"
 #include <string.h>
 
+// The binary index of depend.internal is a sequence of 32-bit words in
+// host byte order: a header, the offset of each interned path in the
+// string area, one {path, first ref, ref count} triple per object, the
+// path of each ref, and the NUL-terminated strings padded to a word.
+enum
+{
+  cmDependsIndexMagic = 0x434d4449,
+  cmDependsIndexVersion = 1,
+  cmDependsIndexHeaderWords = 8
+};
+
+// Header word positions.
+enum
+{
+  cmDependsIndexMagicWord,
+  cmDependsIndexVersionWord,
+  cmDependsIndexTextSizeWord,
+  cmDependsIndexTextTimeWord,
+  cmDependsIndexPathsWord,
+  cmDependsIndexObjectsWord,
+  cmDependsIndexRefsWord,
+  cmDependsIndexStringBytesWord
+};
+
+// Whether a path of the index has been found on disk.
+enum
+{
+  cmDependsIndexPathUnknown,
+  cmDependsIndexPathMissing,
+  cmDependsIndexPathExists
+};
+
 //----------------------------------------------------------------------------
 cmDepends::cmDepends(cmLocalGenerator* lg, const char* targetDir):
   CompileDirectory(),
   LocalGenerator(lg),
   Verbose(false),
+  NeedValidDependencies(true),
   FileComparison(0),
   TargetDirectory(targetDir),
   MaxPath(cmSystemTools::GetMaximumFilePathLength()),
@@ -95,15 +128,26 @@ bool cmDepends::Check(const char *makeFile, const char *internalFile,
     cmSystemTools::ChangeDirectory(this->CompileDirectory.c_str());
     }
 
-  // Check whether dependencies must be regenerated.
+  // Check whether dependencies must be regenerated.  Use the binary
+  // index when it matches the text file.
   bool okay = true;
-  std::ifstream fin(internalFile);
-  if(!(fin && this->CheckDependencies(fin, validDeps)))
+  std::vector<unsigned int> index;
+  if(cmDepends::ReadInternalIndex(internalFile, index))
+    {
+    okay = this->CheckInternalIndex(index, validDeps);
+    }
+  else
+    {
+    std::ifstream fin(internalFile);
+    okay = (fin && this->CheckDependencies(fin, validDeps));
+    }
+  if(!okay)
     {
     // Clear all dependencies so they will be regenerated.
     this->Clear(makeFile);
     cmSystemTools::RemoveFile(internalFile);
-    okay = false;
+    cmSystemTools::RemoveFile(
+      cmDepends::GetInternalIndexFile(internalFile).c_str());
     }
 
   // Restore working directory.
@@ -257,6 +301,313 @@ bool cmDepends::CheckDependencies(std::istream& internalDepends,
   return okay;
 }
 
+//----------------------------------------------------------------------------
+std::string cmDepends::GetInternalIndexFile(const char* internalFile)
+{
+  std::string indexFile = internalFile;
+  indexFile += ".bin";
+  return indexFile;
+}
+
+//----------------------------------------------------------------------------
+void cmDepends::WriteInternalIndex(const char* internalFile)
+{
+  std::string indexFile = cmDepends::GetInternalIndexFile(internalFile);
+  std::ifstream fin(internalFile);
+  if(!fin)
+    {
+    cmSystemTools::RemoveFile(indexFile.c_str());
+    return;
+    }
+
+  // Parse the text file the same way CheckDependencies does and
+  // store each distinct path once.
+  std::map<cmStdString, unsigned int> pathIds;
+  std::vector<unsigned int> pathOffsets;
+  std::vector<unsigned int> objects;
+  std::vector<unsigned int> refs;
+  std::string strings;
+  std::string line;
+  while(cmSystemTools::GetLineFromStream(fin, line))
+    {
+    if(line.empty() || line[0] == '#' || line[0] == '\r')
+      {
+      continue;
+      }
+    bool isDepender = line[0] != ' ';
+    if(!isDepender && objects.empty())
+      {
+      continue;
+      }
+    std::string path = isDepender? line : line.substr(1);
+    std::pair<std::map<cmStdString, unsigned int>::iterator, bool> ins =
+      pathIds.insert(std::make_pair(cmStdString(path),
+                                    static_cast<unsigned int>(
+                                      pathOffsets.size())));
+    if(ins.second)
+      {
+      pathOffsets.push_back(static_cast<unsigned int>(strings.size()));
+      strings += path;
+      strings += '\0';
+      }
+    if(isDepender)
+      {
+      objects.push_back(ins.first->second);
+      objects.push_back(static_cast<unsigned int>(refs.size()));
+      objects.push_back(0);
+      }
+    else
+      {
+      refs.push_back(ins.first->second);
+      ++objects.back();
+      }
+    }
+  fin.close();
+  unsigned int stringBytes = static_cast<unsigned int>(strings.size());
+  strings.resize((strings.size() + 3) & ~static_cast<size_t>(3), '\0');
+
+  unsigned int header[cmDependsIndexHeaderWords];
+  header[cmDependsIndexMagicWord] = cmDependsIndexMagic;
+  header[cmDependsIndexVersionWord] = cmDependsIndexVersion;
+  header[cmDependsIndexTextSizeWord] =
+    static_cast<unsigned int>(cmSystemTools::FileLength(internalFile));
+  header[cmDependsIndexTextTimeWord] =
+    static_cast<unsigned int>(cmSystemTools::ModifiedTime(internalFile));
+  header[cmDependsIndexPathsWord] =
+    static_cast<unsigned int>(pathOffsets.size());
+  header[cmDependsIndexObjectsWord] =
+    static_cast<unsigned int>(objects.size() / 3);
+  header[cmDependsIndexRefsWord] = static_cast<unsigned int>(refs.size());
+  header[cmDependsIndexStringBytesWord] = stringBytes;
+
+  cmGeneratedFileStream fout;
+  fout.Open(indexFile.c_str(), true, true);
+  fout.write(reinterpret_cast<const char*>(header), sizeof(header));
+  if(!pathOffsets.empty())
+    {
+    fout.write(reinterpret_cast<const char*>(&pathOffsets[0]),
+               pathOffsets.size() * sizeof(unsigned int));
+    }
+  if(!objects.empty())
+    {
+    fout.write(reinterpret_cast<const char*>(&objects[0]),
+               objects.size() * sizeof(unsigned int));
+    }
+  if(!refs.empty())
+    {
+    fout.write(reinterpret_cast<const char*>(&refs[0]),
+               refs.size() * sizeof(unsigned int));
+    }
+  fout.write(strings.data(), strings.size());
+  if(!fout.Close())
+    {
+    cmSystemTools::RemoveFile(indexFile.c_str());
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmDepends::ReadInternalIndex(const char* internalFile,
+                                  std::vector<unsigned int>& index)
+{
+  std::string indexFile = cmDepends::GetInternalIndexFile(internalFile);
+  unsigned long length = cmSystemTools::FileLength(indexFile.c_str());
+  if(length < cmDependsIndexHeaderWords * sizeof(unsigned int) ||
+     length % sizeof(unsigned int) != 0)
+    {
+    return false;
+    }
+
+  // Read the whole index with one call into word-aligned storage.
+  unsigned long words = length / sizeof(unsigned int);
+  index.resize(words);
+#if defined(_WIN32) || defined(__CYGWIN__)
+  std::ifstream fin(indexFile.c_str(), std::ios::in | std::ios::binary);
+#else
+  std::ifstream fin(indexFile.c_str(), std::ios::in);
+#endif
+  if(!fin || !fin.read(reinterpret_cast<char*>(&index[0]),
+                       static_cast<std::streamsize>(length)))
+    {
+    return false;
+    }
+
+  // The index must describe the current text file.
+  const unsigned int* header = &index[0];
+  if(header[cmDependsIndexMagicWord] != cmDependsIndexMagic ||
+     header[cmDependsIndexVersionWord] != cmDependsIndexVersion ||
+     header[cmDependsIndexTextSizeWord] !=
+     static_cast<unsigned int>(cmSystemTools::FileLength(internalFile)) ||
+     header[cmDependsIndexTextTimeWord] !=
+     static_cast<unsigned int>(cmSystemTools::ModifiedTime(internalFile)))
+    {
+    return false;
+    }
+
+  // Validate the table sizes and every index stored in them so that
+  // the check can use them without further tests.
+  unsigned long numPaths = header[cmDependsIndexPathsWord];
+  unsigned long numObjects = header[cmDependsIndexObjectsWord];
+  unsigned long numRefs = header[cmDependsIndexRefsWord];
+  unsigned long stringBytes = header[cmDependsIndexStringBytesWord];
+  if(numPaths > words || numObjects > words || numRefs > words ||
+     stringBytes > length ||
+     (cmDependsIndexHeaderWords + numPaths + 3*numObjects + numRefs +
+      (stringBytes + 3) / 4) != words)
+    {
+    return false;
+    }
+  const unsigned int* pathOffsets = header + cmDependsIndexHeaderWords;
+  const unsigned int* objects = pathOffsets + numPaths;
+  const unsigned int* refs = objects + 3*numObjects;
+  const char* strings = reinterpret_cast<const char*>(refs + numRefs);
+  if(numPaths > 0 && (stringBytes == 0 || strings[stringBytes-1] != 0))
+    {
+    return false;
+    }
+  for(unsigned long i = 0; i < numPaths; ++i)
+    {
+    if(pathOffsets[i] >= stringBytes)
+      {
+      return false;
+      }
+    }
+  for(unsigned long i = 0; i < numObjects; ++i)
+    {
+    const unsigned int* object = objects + 3*i;
+    if(object[0] >= numPaths || object[1] > numRefs ||
+       object[2] > numRefs - object[1])
+      {
+      return false;
+      }
+    }
+  for(unsigned long i = 0; i < numRefs; ++i)
+    {
+    if(refs[i] >= numPaths)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmDepends::CheckInternalIndex(std::vector<unsigned int> const& index,
+                            std::map<std::string, DependencyVector>& validDeps)
+{
+  const unsigned int* header = &index[0];
+  unsigned int numPaths = header[cmDependsIndexPathsWord];
+  unsigned int numObjects = header[cmDependsIndexObjectsWord];
+  unsigned int numRefs = header[cmDependsIndexRefsWord];
+  const unsigned int* pathOffsets = header + cmDependsIndexHeaderWords;
+  const unsigned int* objects = pathOffsets + numPaths;
+  const unsigned int* refs = objects + 3*numObjects;
+  const char* strings = reinterpret_cast<const char*>(refs + numRefs);
+
+  // This follows CheckDependencies but looks for each dependee on disk
+  // only once no matter how many objects include it.
+  std::vector<unsigned char> pathState(numPaths, cmDependsIndexPathUnknown);
+  std::vector<bool> objectInvalid(numObjects, false);
+  bool okay = true;
+  for(unsigned int o = 0; o < numObjects; ++o)
+    {
+    const unsigned int* object = objects + 3*o;
+    const char* depender = strings + pathOffsets[object[0]];
+    bool dependerExists = cmSystemTools::FileExists(depender);
+    const unsigned int* ref = refs + object[1];
+    const unsigned int* refEnd = ref + object[2];
+    for(; ref != refEnd; ++ref)
+      {
+      const char* dependee = strings + pathOffsets[*ref];
+      unsigned char& state = pathState[*ref];
+      if(state == cmDependsIndexPathUnknown)
+        {
+        state = (cmSystemTools::FileExists(dependee)?
+                 cmDependsIndexPathExists : cmDependsIndexPathMissing);
+        }
+
+      // Dependencies must be regenerated if the dependee does not exist
+      // or if the depender exists and is older than the dependee.
+      bool regenerate = false;
+      if(state == cmDependsIndexPathMissing)
+        {
+        // The dependee does not exist.
+        regenerate = true;
+
+        // Print verbose output.
+        if(this->Verbose)
+          {
+          cmOStringStream msg;
+          msg << "Dependee \"" << dependee
+              << "\" does not exist for depender \""
+              << depender << "\"." << std::endl;
+          cmSystemTools::Stdout(msg.str().c_str());
+          }
+        }
+      else if(dependerExists)
+        {
+        // The dependee and depender both exist.  Compare file times.
+        int result = 0;
+        if((!this->FileComparison->FileTimeCompare(depender, dependee,
+                                                   &result) || result < 0))
+          {
+          // The depender is older than the dependee.
+          regenerate = true;
+
+          // Print verbose output.
+          if(this->Verbose)
+            {
+            cmOStringStream msg;
+            msg << "Dependee \"" << dependee
+                << "\" is newer than depender \""
+                << depender << "\"." << std::endl;
+            cmSystemTools::Stdout(msg.str().c_str());
+            }
+          }
+        }
+      if(regenerate)
+        {
+        // Dependencies must be regenerated.
+        okay = false;
+        objectInvalid[o] = true;
+
+        // Remove the depender to be sure it is rebuilt.
+        if (dependerExists)
+          {
+          cmSystemTools::RemoveFile(depender);
+          pathState[object[0]] = cmDependsIndexPathMissing;
+          dependerExists = false;
+          }
+        }
+      }
+    }
+
+  // Store the dependencies that are still valid only if the caller
+  // will rescan anything.
+  if(okay && !this->NeedValidDependencies)
+    {
+    return okay;
+    }
+  for(unsigned int o = 0; o < numObjects; ++o)
+    {
+    const unsigned int* object = objects + 3*o;
+    const char* depender = strings + pathOffsets[object[0]];
+    if(objectInvalid[o])
+      {
+      validDeps.erase(depender);
+      continue;
+      }
+    DependencyVector& deps = validDeps[depender];
+    deps.clear();
+    const unsigned int* ref = refs + object[1];
+    const unsigned int* refEnd = ref + object[2];
+    for(; ref != refEnd; ++ref)
+      {
+      deps.push_back(strings + pathOffsets[*ref]);
+      }
+    }
+  return okay;
+}
+
 //----------------------------------------------------------------------------
 void cmDepends::SetIncludePathFromLanguage(const char* lang)
 {
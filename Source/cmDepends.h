@@ -65,9 +65,23 @@ public:
   bool Check(const char *makeFile, const char* internalFile,
              std::map<std::string, DependencyVector>& validDeps);
 
+  /** Set whether Check must store the valid dependencies even when
+      all of them are still valid.  Callers only need them for a
+      rescan, so without this a fully valid index skips building them.
+      Defaults to true.  */
+  void SetNeedValidDependencies(bool b) { this->NeedValidDependencies = b; }
+
   /** Clear dependencies for the target file so they will be regenerated.  */
   void Clear(const char *file);
 
+  /** Write the binary index of the given internal dependency file.
+      Check reads the index instead of the text file while the index
+      matches it.  The text file is kept for debugging.  */
+  static void WriteInternalIndex(const char* internalFile);
+
+  /** Get the name of the binary index of an internal dependency file.  */
+  static std::string GetInternalIndexFile(const char* internalFile);
+
   /** Set the file comparison object */
   void SetFileComparison(cmFileTimeComparison* fc) { 
     this->FileComparison = fc; }
@@ -85,6 +99,15 @@ protected:
   virtual bool CheckDependencies(std::istream& internalDepends,
                            std::map<std::string, DependencyVector>& validDeps);
 
+  // Check dependencies using the binary index read by ReadInternalIndex.
+  bool CheckInternalIndex(std::vector<unsigned int> const& index,
+                          std::map<std::string, DependencyVector>& validDeps);
+
+  // Read the binary index of the internal dependency file.  Return
+  // false if it is missing, malformed or out of date with the text.
+  static bool ReadInternalIndex(const char* internalFile,
+                                std::vector<unsigned int>& index);
+
   // Finalize the dependency information for the target.
   virtual bool Finalize(std::ostream& makeDepends,
                         std::ostream& internalDepends);
@@ -97,6 +120,7 @@ protected:
 
   // Flag for verbose output.
   bool Verbose;
+  bool NeedValidDependencies;
   cmFileTimeComparison* FileComparison;
 
   std::string Language;
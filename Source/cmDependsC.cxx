@@ -15,9 +15,14 @@
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
 #include "cmSystemTools.h"
+#include "cmake.h"
 
 #include <ctype.h> // isspace
 
+#if !defined(_WIN32) || defined(__CYGWIN__)
+# include <sys/stat.h>
+#endif
+
 
 #define INCLUDE_REGEX_LINE \
   "^[ \t]*#[ \t]*(include|import)[ \t]*[<\"]([^\">]+)([\">])"
@@ -26,10 +31,13 @@
 #define INCLUDE_REGEX_SCAN_MARKER "#IncludeRegexScan: "
 #define INCLUDE_REGEX_COMPLAIN_MARKER "#IncludeRegexComplain: "
 #define INCLUDE_REGEX_TRANSFORM_MARKER "#IncludeRegexTransform: "
+#define SHARED_CACHE_MARKER "#SharedIncludeCache 1"
 
 //----------------------------------------------------------------------------
 cmDependsC::cmDependsC()
-: ValidDeps(0)
+: IncludeRegexScanAll(true)
+, ValidDeps(0)
+, SharedCacheChanged(false)
 {
 }
 
@@ -39,7 +47,9 @@ cmDependsC::cmDependsC(cmLocalGenerator* lg,
                    const char* lang,
                    const std::map<std::string, DependencyVector>* validDeps)
 : cmDepends(lg, targetDir)
+, IncludeRegexScanAll(false)
 , ValidDeps(validDeps)
+, SharedCacheChanged(false)
 {
   cmMakefile* mf = lg->GetMakefile();
 
@@ -66,8 +76,8 @@ cmDependsC::cmDependsC(cmLocalGenerator* lg,
     }
   }
 
-  this->IncludeRegexLine.compile(INCLUDE_REGEX_LINE);
   this->IncludeRegexScan.compile(scanRegex.c_str());
+  this->IncludeRegexScanAll = (scanRegex == "^.*$");
   this->IncludeRegexComplain.compile(complainRegex.c_str());
   this->IncludeRegexLineString = INCLUDE_REGEX_LINE_MARKER INCLUDE_REGEX_LINE;
   this->IncludeRegexScanString = INCLUDE_REGEX_SCAN_MARKER;
@@ -83,12 +93,33 @@ cmDependsC::cmDependsC(cmLocalGenerator* lg,
   this->CacheFileName += ".includecache";
 
   this->ReadCacheFile();
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Targets scanned with the same rules share one cache of include
+  // lines for the whole build tree.
+  std::string rules = this->IncludeRegexLineString;
+  rules += "\n";
+  rules += this->IncludeRegexScanString;
+  rules += "\n";
+  rules += this->IncludeRegexComplainString;
+  rules += "\n";
+  rules += this->IncludeRegexTransformString;
+  this->SharedCacheFileName = mf->GetHomeOutputDirectory();
+  this->SharedCacheFileName += cmake::GetCMakeFilesDirectory();
+  this->SharedCacheFileName += "/";
+  this->SharedCacheFileName += lang;
+  this->SharedCacheFileName += ".";
+  this->SharedCacheFileName += cmSystemTools::ComputeStringMD5(rules.c_str());
+  this->SharedCacheFileName += ".includecache";
+  this->ReadSharedCacheFile();
+#endif
 }
 
 //----------------------------------------------------------------------------
 cmDependsC::~cmDependsC()
 {
   this->WriteCacheFile();
+  this->WriteSharedCacheFile();
 
   for (std::map<cmStdString, cmIncludeLines*>::iterator it=
          this->FileCache.begin(); it!=this->FileCache.end(); ++it)
@@ -164,13 +195,13 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
     std::string fullName;
     if(first || cmSystemTools::FileIsFullPath(current.FileName.c_str()))
       {
-      if(cmSystemTools::FileExists(current.FileName.c_str(), true))
+      if(this->FileExists(current.FileName))
         {
         fullName = current.FileName;
         }
       }
     else if(!current.QuotedLocation.empty() &&
-            cmSystemTools::FileExists(current.QuotedLocation.c_str(), true))
+            this->FileExists(current.QuotedLocation))
       {
       // The include statement producing this entry was a double-quote
       // include and the included file is present in the directory of
@@ -204,7 +235,7 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
           }
 
         // Look for the file in this location.
-        if(cmSystemTools::FileExists(tempPathStr.c_str(), true))
+        if(this->FileExists(tempPathStr))
           {
           fullName = tempPathStr;
           HeaderLocationCache[current.FileName]=fullName;
@@ -229,16 +260,26 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
       // Record scanned files.
       scanned.insert(fullName);
 
-      // Check whether this file is already in the cache
+      // Check whether this file is already in the cache of this
+      // target or in the cache shared by all targets.
+      cmIncludeLines* lines = 0;
       std::map<cmStdString, cmIncludeLines*>::iterator fileIt=
         this->FileCache.find(fullName);
       if (fileIt!=this->FileCache.end())
         {
-        fileIt->second->Used=true;
+        lines = fileIt->second;
+        }
+      else
+        {
+        lines = this->FindSharedCacheEntry(fullName);
+        }
+      if (lines)
+        {
+        lines->Used=true;
         dependencies.insert(fullName);
         for (std::vector<UnscannedEntry>::const_iterator incIt=
-               fileIt->second->UnscannedEntries.begin(); 
-             incIt!=fileIt->second->UnscannedEntries.end(); ++incIt)
+               lines->UnscannedEntries.begin();
+             incIt!=lines->UnscannedEntries.end(); ++incIt)
           {
           if (this->Encountered.find(incIt->FileName) == 
               this->Encountered.end())
@@ -252,7 +293,10 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
         {
 
         // Try to scan the file.  Just leave it out if we cannot find
-        // it.
+        // it.  Get the stamp first so a change during the scan is
+        // noticed by later scans.
+        cmStdString stamp;
+        bool haveStamp = this->GetFileStamp(fullName.c_str(), stamp);
         std::ifstream fin(fullName.c_str());
         if(fin)
           {
@@ -263,6 +307,10 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
           // containing the file to handle double-quote includes.
           std::string dir = cmSystemTools::GetFilenamePath(fullName);
           this->Scan(fin, dir.c_str(), fullName);
+          if(haveStamp)
+            {
+            this->StoreSharedCacheEntry(fullName, stamp);
+            }
           }
         }
       }
@@ -290,6 +338,19 @@ bool cmDependsC::WriteDependencies(const char *src, const char *obj,
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool cmDependsC::FileExists(std::string const& fname)
+{
+  std::map<cmStdString, bool>::iterator i = this->FileExistsCache.find(fname);
+  if(i == this->FileExistsCache.end())
+    {
+    bool exists = cmSystemTools::FileExists(fname.c_str(), true);
+    i = this->FileExistsCache.insert(
+      std::map<cmStdString, bool>::value_type(fname, exists)).first;
+    }
+  return i->second;
+}
+
 //----------------------------------------------------------------------------
 void cmDependsC::ReadCacheFile()
 {
@@ -424,6 +485,163 @@ void cmDependsC::WriteCacheFile() const
    }
 }
 
+//----------------------------------------------------------------------------
+bool cmDependsC::GetFileStamp(const char* fname, cmStdString& stamp)
+{
+  cmOStringStream s;
+#if !defined(_WIN32) || defined(__CYGWIN__)
+  struct stat st;
+  if(::stat(fname, &st) != 0)
+    {
+    return false;
+    }
+  s << static_cast<long>(st.st_mtime);
+# if cmsys_STAT_HAS_ST_MTIM
+  s << "." << static_cast<long>(st.st_mtim.tv_nsec);
+# endif
+  s << " " << static_cast<unsigned long>(st.st_size);
+#else
+  if(!cmSystemTools::FileExists(fname))
+    {
+    return false;
+    }
+  s << cmSystemTools::ModifiedTime(fname) << " "
+    << cmSystemTools::FileLength(fname);
+#endif
+  stamp = s.str();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+cmDependsC::cmIncludeLines*
+cmDependsC::FindSharedCacheEntry(const cmStdString& fullName)
+{
+  std::map<cmStdString, SharedCacheEntry>::const_iterator i =
+    this->SharedCache.find(fullName);
+  if(i == this->SharedCache.end())
+    {
+    return 0;
+    }
+  cmStdString stamp;
+  if(!this->GetFileStamp(fullName.c_str(), stamp) ||
+     stamp != i->second.Stamp)
+    {
+    return 0;
+    }
+  cmIncludeLines* lines = new cmIncludeLines;
+  lines->UnscannedEntries = i->second.UnscannedEntries;
+  this->FileCache[fullName] = lines;
+  return lines;
+}
+
+//----------------------------------------------------------------------------
+void cmDependsC::StoreSharedCacheEntry(const cmStdString& fullName,
+                                       const cmStdString& stamp)
+{
+  if(this->SharedCacheFileName.empty())
+    {
+    return;
+    }
+  SharedCacheEntry& entry = this->SharedCache[fullName];
+  entry.Stamp = stamp;
+  entry.UnscannedEntries = this->FileCache[fullName]->UnscannedEntries;
+  this->SharedCacheChanged = true;
+}
+
+//----------------------------------------------------------------------------
+void cmDependsC::ReadSharedCacheFile()
+{
+  std::ifstream fin(this->SharedCacheFileName.c_str());
+  if(!fin)
+    {
+    return;
+    }
+
+  // Ignore files written in another format.
+  std::string line;
+  if(!cmSystemTools::GetLineFromStream(fin, line) ||
+     line != SHARED_CACHE_MARKER)
+    {
+    return;
+    }
+
+  // Each entry is the file name, its stamp, and pairs of lines for
+  // the include lines it contains, followed by an empty line.
+  while(cmSystemTools::GetLineFromStream(fin, line))
+    {
+    if(line.empty())
+      {
+      continue;
+      }
+    std::string stamp;
+    if(!cmSystemTools::GetLineFromStream(fin, stamp))
+      {
+      break;
+      }
+    SharedCacheEntry& entry = this->SharedCache[line];
+    entry.Stamp = stamp;
+    UnscannedEntry include;
+    while(cmSystemTools::GetLineFromStream(fin, include.FileName) &&
+          !include.FileName.empty() &&
+          cmSystemTools::GetLineFromStream(fin, include.QuotedLocation))
+      {
+      if(include.QuotedLocation == "-")
+        {
+        include.QuotedLocation = "";
+        }
+      entry.UnscannedEntries.push_back(include);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmDependsC::WriteSharedCacheFile()
+{
+  if(!this->SharedCacheChanged)
+    {
+    return;
+    }
+
+  // Scans of other targets may write the file at the same time.
+  // Write a temporary file owned by this target and rename it into
+  // place so every reader sees a complete file.
+  std::string tmpName = this->CacheFileName + ".shared.tmp";
+  std::ofstream cacheOut(tmpName.c_str());
+  if(!cacheOut)
+    {
+    return;
+    }
+  cacheOut << SHARED_CACHE_MARKER << "\n";
+  for(std::map<cmStdString, SharedCacheEntry>::const_iterator fileIt =
+        this->SharedCache.begin(); fileIt != this->SharedCache.end();
+      ++fileIt)
+    {
+    cacheOut << "\n" << fileIt->first << "\n"
+             << fileIt->second.Stamp << "\n";
+    for(std::vector<UnscannedEntry>::const_iterator incIt =
+          fileIt->second.UnscannedEntries.begin();
+        incIt != fileIt->second.UnscannedEntries.end(); ++incIt)
+      {
+      cacheOut << incIt->FileName << "\n";
+      if(incIt->QuotedLocation.empty())
+        {
+        cacheOut << "-\n";
+        }
+      else
+        {
+        cacheOut << incIt->QuotedLocation << "\n";
+        }
+      }
+    }
+  cacheOut.close();
+  if(!cacheOut ||
+     !cmSystemTools::RenameFile(tmpName.c_str(),
+                                this->SharedCacheFileName.c_str()))
+    {
+    cmSystemTools::RemoveFile(tmpName.c_str());
+    }
+}
+
 //----------------------------------------------------------------------------
 void cmDependsC::Scan(std::istream& is, const char* directory,
   const cmStdString& fullName)
@@ -431,25 +649,49 @@ void cmDependsC::Scan(std::istream& is, const char* directory,
   cmIncludeLines* newCacheEntry=new cmIncludeLines;
   newCacheEntry->Used=true;
   this->FileCache[fullName]=newCacheEntry;
-  
-  // Read one line at a time.
+
+  // Read the whole file.
+  this->Buffer.clear();
+  char chunk[16384];
+  while(is.read(chunk, sizeof(chunk)) || is.gcount() > 0)
+    {
+    this->Buffer.insert(this->Buffer.end(), chunk, chunk + is.gcount());
+    }
+  const char* s = this->Buffer.empty()? 0 : &this->Buffer[0];
+  const char* end = s + this->Buffer.size();
+
+  // Look at one line at a time.
   std::string line;
-  while(cmSystemTools::GetLineFromStream(is, line))
+  while(s != end)
     {
-    // Transform the line content first.
-    if(!this->TransformRules.empty())
+    const char* eol = static_cast<const char*>(memchr(s, '\n', end-s));
+    const char* next = eol? eol+1 : end;
+    const char* e = eol? eol : end;
+    if(e != s && e[-1] == '\r')
       {
-      this->TransformLine(line);
+      --e;
       }
 
-    // Match include directives.
-    if(this->IncludeRegexLine.find(line.c_str()))
+    // Match include directives.  Transform the line content first.
+    UnscannedEntry entry;
+    bool quoted = false;
+    bool found;
+    if(this->TransformRules.empty())
+      {
+      found = ParseIncludeLine(s, e, entry.FileName, quoted);
+      }
+    else
+      {
+      line.assign(s, e);
+      this->TransformLine(line);
+      found = ParseIncludeLine(line.c_str(), line.c_str() + line.size(),
+                               entry.FileName, quoted);
+      }
+    s = next;
+    if(found)
       {
       // Get the file being included.
-      UnscannedEntry entry;
-      entry.FileName = this->IncludeRegexLine.match(2);
-      if(this->IncludeRegexLine.match(3) == "\"" &&
-         !cmSystemTools::FileIsFullPath(entry.FileName.c_str()))
+      if(quoted && !cmSystemTools::FileIsFullPath(entry.FileName.c_str()))
         {
         // This was a double-quoted include with a relative path.  We
         // must check for the file in the directory containing the
@@ -466,7 +708,8 @@ void cmDependsC::Scan(std::istream& is, const char* directory,
       // is included by double-quotes and the other by angle brackets.
       // This kind of problem will be fixed when a more
       // preprocessor-like implementation of this scanner is created.
-      if (this->IncludeRegexScan.find(entry.FileName.c_str()))
+      if (this->IncludeRegexScanAll ||
+          this->IncludeRegexScan.find(entry.FileName.c_str()))
         {
         newCacheEntry->UnscannedEntries.push_back(entry);
         if(this->Encountered.find(entry.FileName) == this->Encountered.end())
@@ -479,6 +722,63 @@ void cmDependsC::Scan(std::istream& is, const char* directory,
     }
 }
 
+//----------------------------------------------------------------------------
+bool cmDependsC::ParseIncludeLine(const char* begin, const char* end,
+                                  std::string& fileName, bool& quoted)
+{
+  // Most lines are not preprocessor directives.  Reject them with as
+  // few comparisons as possible.  A NUL ends the line as it would in
+  // the regular expression.
+  const char* c = begin;
+  while(c != end && (*c == ' ' || *c == '\t'))
+    {
+    ++c;
+    }
+  if(c == end || *c != '#')
+    {
+    return false;
+    }
+  ++c;
+  while(c != end && (*c == ' ' || *c == '\t'))
+    {
+    ++c;
+    }
+  if(end - c >= 7 && strncmp(c, "include", 7) == 0)
+    {
+    c += 7;
+    }
+  else if(end - c >= 6 && strncmp(c, "import", 6) == 0)
+    {
+    c += 6;
+    }
+  else
+    {
+    return false;
+    }
+  while(c != end && (*c == ' ' || *c == '\t'))
+    {
+    ++c;
+    }
+  if(c == end || (*c != '<' && *c != '"'))
+    {
+    return false;
+    }
+
+  // The name is everything up to the first closing quote or bracket.
+  const char* name = ++c;
+  while(c != end && *c != '"' && *c != '>' && *c != '\0')
+    {
+    ++c;
+    }
+  if(c == name || c == end || *c == '\0')
+    {
+    return false;
+    }
+  fileName.assign(name, c);
+  quoted = (*c == '"');
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void cmDependsC::SetupTransforms()
 {
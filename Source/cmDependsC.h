@@ -44,12 +44,11 @@ protected:
   void Scan(std::istream& is, const char* directory,
     const cmStdString& fullName);
 
-  // Regular expression to identify C preprocessor include directives.
-  cmsys::RegularExpression IncludeRegexLine;
-
   // Regular expressions to choose which include files to scan
-  // recursively and which to complain about not finding.
+  // recursively and which to complain about not finding.  The default
+  // scan expression matches every file so it need not be evaluated.
   cmsys::RegularExpression IncludeRegexScan;
+  bool IncludeRegexScanAll;
   cmsys::RegularExpression IncludeRegexComplain;
   std::string IncludeRegexLineString;
   std::string IncludeRegexScanString;
@@ -65,6 +64,13 @@ protected:
   void TransformLine(std::string& line);
 
 public:
+  /** Match the line in [begin, end) against the include directive
+      expression INCLUDE_REGEX_LINE without a regular expression.
+      Returns true with the name of the included file and whether it
+      was closed by a double quote on a match.  */
+  static bool ParseIncludeLine(const char* begin, const char* end,
+                               std::string& fileName, bool& quoted);
+
   // Data structures for dependency graph walk.
   struct UnscannedEntry
   {
@@ -87,10 +93,34 @@ protected:
   std::map<cmStdString, cmIncludeLines *> FileCache;
   std::map<cmStdString, cmStdString> HeaderLocationCache;
 
+  // Whether each file looked up by the scan exists.  The sources of a
+  // target mostly include the same headers, so each is checked once.
+  std::map<cmStdString, bool> FileExistsCache;
+  bool FileExists(std::string const& fname);
+
   cmStdString CacheFileName;
 
   void WriteCacheFile() const;
   void ReadCacheFile();
+
+  // Include lines of files shared by the scans of all targets in the
+  // build tree that use the same regular expressions.  An entry is
+  // valid while the file has the recorded modification time and size.
+  struct SharedCacheEntry
+  {
+    cmStdString Stamp;
+    std::vector<UnscannedEntry> UnscannedEntries;
+  };
+  std::map<cmStdString, SharedCacheEntry> SharedCache;
+  cmStdString SharedCacheFileName;
+  bool SharedCacheChanged;
+
+  void ReadSharedCacheFile();
+  void WriteSharedCacheFile();
+  cmIncludeLines* FindSharedCacheEntry(const cmStdString& fullName);
+  void StoreSharedCacheEntry(const cmStdString& fullName,
+                             const cmStdString& stamp);
+  static bool GetFileStamp(const char* fname, cmStdString& stamp);
 private:
   cmDependsC(cmDependsC const&); // Purposely not implemented.
   void operator=(cmDependsC const&); // Purposely not implemented.
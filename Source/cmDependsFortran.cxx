@@ -15,6 +15,7 @@
 #include "cmLocalGenerator.h"
 #include "cmMakefile.h"
 #include "cmGeneratedFileStream.h"
+#include "cmake.h"
 
 #include "cmDependsFortranParser.h" /* Interface to parser object.  */
 
@@ -39,8 +40,43 @@ public:
 
   // Set of files included in the translation unit.
   std::set<cmStdString> Includes;
+
+  // Map each include statement, as the directory of the including
+  // file and the name included, to the file it resolved to.  The file
+  // is empty if the include could not be found.
+  typedef std::pair<cmStdString, cmStdString> IncludeKey;
+  typedef std::map<IncludeKey, cmStdString> IncludeLookupMap;
+  IncludeLookupMap IncludeLookups;
+};
+
+//----------------------------------------------------------------------------
+// The size and modification time of a file along with its content
+// hash.  A zero time means the time cannot be trusted to detect a
+// change and the content must be hashed.
+struct cmDependsFortranFileStamp
+{
+  cmDependsFortranFileStamp(): Size(0), Time(0) {}
+  std::string Hash;
+  unsigned long Size;
+  long Time;
+};
+
+//----------------------------------------------------------------------------
+// The modules and includes found by parsing a source file, shared by
+// the scans of all targets in the build tree.  An entry is valid while
+// the source and every file it includes have the recorded content and
+// every include statement still resolves to the same file.
+struct cmDependsFortranIndexEntry
+{
+  cmDependsFortranFileStamp Stamp;
+  std::set<cmStdString> Provides;
+  std::set<cmStdString> Requires;
+  std::map<cmStdString, cmDependsFortranFileStamp> Includes;
+  cmDependsFortranSourceInfo::IncludeLookupMap IncludeLookups;
 };
 
+#define FORTRAN_MODULE_INDEX_MARKER "#FortranModuleIndex 2"
+
 //----------------------------------------------------------------------------
 // Parser methods not included in generated interface.
 
@@ -122,8 +158,366 @@ public:
       }
     return i->second;
     }
+
+  // Index of parse results keyed by the scan context and source file.
+  typedef std::map<cmStdString, cmDependsFortranIndexEntry> ModuleIndexMap;
+  ModuleIndexMap ModuleIndex;
+  std::set<cmStdString> ModuleIndexChanged;
+  std::string ModuleIndexFile;
+  std::string ModuleIndexContext;
+
+  // Stamps of files checked during this scan.
+  typedef std::map<cmStdString, cmDependsFortranFileStamp> FileStampMap;
+  FileStampMap FileStamps;
+
+  // Files modified at or after this time may change again without
+  // getting a new time, so their stamps do not record a time.
+  long ScanTime;
+
+  // Get the current stamp of a file, hashing its content if requested.
+  // Returns null if the file cannot be read.
+  cmDependsFortranFileStamp const* GetFileStamp(const char* fname,
+                                                bool hash);
+
+  bool FileUnchanged(const char* fname, cmDependsFortranFileStamp& stamp,
+                     bool& restamped);
+  bool FindIndexEntry(cmDependsFortran* self, const char* src,
+                      cmDependsFortranSourceInfo& info);
+  void StoreIndexEntry(const char* src,
+                       cmDependsFortranSourceInfo const& info);
+  static void ReadModuleIndex(const char* fname, ModuleIndexMap& index);
+  void WriteModuleIndex(const char* tmpName);
 };
 
+//----------------------------------------------------------------------------
+cmDependsFortranFileStamp const*
+cmDependsFortranInternals::GetFileStamp(const char* fname, bool hash)
+{
+  FileStampMap::iterator i = this->FileStamps.find(fname);
+  if(i == this->FileStamps.end())
+    {
+    if(!cmSystemTools::FileExists(fname, true))
+      {
+      return 0;
+      }
+    cmDependsFortranFileStamp stamp;
+    stamp.Size = cmSystemTools::FileLength(fname);
+    stamp.Time = cmSystemTools::ModifiedTime(fname);
+    if(stamp.Time >= this->ScanTime)
+      {
+      stamp.Time = 0;
+      }
+    i = this->FileStamps.insert(FileStampMap::value_type(fname, stamp)).first;
+    }
+  if(hash && i->second.Hash.empty())
+    {
+    char md5[32];
+    if(!cmSystemTools::ComputeFileMD5(fname, md5))
+      {
+      return 0;
+      }
+    i->second.Hash.assign(md5, 32);
+    }
+  return &i->second;
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsFortranInternals::FileUnchanged(
+  const char* fname, cmDependsFortranFileStamp& stamp, bool& restamped)
+{
+  // Trust an unchanged size and time.  Otherwise compare the content.
+  cmDependsFortranFileStamp const* current = this->GetFileStamp(fname, false);
+  if(!current)
+    {
+    return false;
+    }
+  if(stamp.Time != 0 &&
+     current->Time == stamp.Time && current->Size == stamp.Size)
+    {
+    return true;
+    }
+  current = this->GetFileStamp(fname, true);
+  if(!current || current->Hash != stamp.Hash)
+    {
+    return false;
+    }
+
+  // The file was touched without changing.  Record its new time so
+  // later scans need not hash it again.
+  if(current->Time != stamp.Time || current->Size != stamp.Size)
+    {
+    stamp.Size = current->Size;
+    stamp.Time = current->Time;
+    restamped = true;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmDependsFortranInternals::FindIndexEntry(
+  cmDependsFortran* self, const char* src, cmDependsFortranSourceInfo& info)
+{
+  std::string key = this->ModuleIndexContext + src;
+  ModuleIndexMap::iterator i = this->ModuleIndex.find(key);
+  if(i == this->ModuleIndex.end())
+    {
+    return false;
+    }
+  cmDependsFortranIndexEntry& entry = i->second;
+  bool restamped = false;
+  if(!this->FileUnchanged(src, entry.Stamp, restamped))
+    {
+    return false;
+    }
+  for(std::map<cmStdString, cmDependsFortranFileStamp>::iterator
+        inc = entry.Includes.begin(); inc != entry.Includes.end(); ++inc)
+    {
+    if(!this->FileUnchanged(inc->first.c_str(), inc->second, restamped))
+      {
+      return false;
+      }
+    }
+
+  // An include statement may now find a different file, such as a
+  // generated file that did not exist or one earlier in the path.
+  for(cmDependsFortranSourceInfo::IncludeLookupMap::const_iterator
+        l = entry.IncludeLookups.begin(); l != entry.IncludeLookups.end();
+      ++l)
+    {
+    std::string fullName;
+    if(!self->FindIncludeFile(l->first.first.c_str(),
+                              l->first.second.c_str(), fullName))
+      {
+      fullName = "";
+      }
+    if(fullName != l->second)
+      {
+      return false;
+      }
+    }
+
+  info.Provides.insert(entry.Provides.begin(), entry.Provides.end());
+  info.Requires.insert(entry.Requires.begin(), entry.Requires.end());
+  for(std::map<cmStdString, cmDependsFortranFileStamp>::const_iterator
+        inc = entry.Includes.begin(); inc != entry.Includes.end(); ++inc)
+    {
+    info.Includes.insert(inc->first);
+    }
+  if(restamped)
+    {
+    this->ModuleIndexChanged.insert(key);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmDependsFortranInternals::StoreIndexEntry(
+  const char* src, cmDependsFortranSourceInfo const& info)
+{
+  // Do not record a result that depends on an unreadable file.
+  cmDependsFortranIndexEntry entry;
+  cmDependsFortranFileStamp const* stamp = this->GetFileStamp(src, true);
+  if(!stamp)
+    {
+    return;
+    }
+  entry.Stamp = *stamp;
+  entry.Provides = info.Provides;
+  entry.Requires = info.Requires;
+  for(std::set<cmStdString>::const_iterator i = info.Includes.begin();
+      i != info.Includes.end(); ++i)
+    {
+    if(!(stamp = this->GetFileStamp(i->c_str(), true)))
+      {
+      return;
+      }
+    entry.Includes[*i] = *stamp;
+    }
+  entry.IncludeLookups = info.IncludeLookups;
+  std::string key = this->ModuleIndexContext + src;
+  this->ModuleIndex[key] = entry;
+  this->ModuleIndexChanged.insert(key);
+}
+
+//----------------------------------------------------------------------------
+// Stamps are stored as "<hash> <size> <time>", optionally followed by
+// a space and a file name.
+static bool cmDependsFortranReadStamp(std::string const& value,
+                                      cmDependsFortranFileStamp& stamp,
+                                      std::string* fname)
+{
+  int n = 0;
+  if(value.size() < 33 ||
+     sscanf(value.c_str() + 32, " %lu %ld%n", &stamp.Size, &stamp.Time,
+            &n) != 2)
+    {
+    return false;
+    }
+  stamp.Hash = value.substr(0, 32);
+  if(fname)
+    {
+    std::string::size_type pos = 32 + n;
+    if(pos >= value.size() || value[pos] != ' ')
+      {
+      return false;
+      }
+    *fname = value.substr(pos + 1);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+static void cmDependsFortranWriteStamp(std::ostream& os,
+                                       cmDependsFortranFileStamp const& s)
+{
+  os << s.Hash << " " << s.Size << " " << s.Time;
+}
+
+//----------------------------------------------------------------------------
+void cmDependsFortranInternals::ReadModuleIndex(const char* fname,
+                                                ModuleIndexMap& index)
+{
+  std::ifstream fin(fname);
+  std::string line;
+  if(!fin || !cmSystemTools::GetLineFromStream(fin, line) ||
+     line != FORTRAN_MODULE_INDEX_MARKER)
+    {
+    return;
+    }
+
+  // Each entry starts with its key and is followed by lines for the
+  // source stamp, provided and required modules, included files, and
+  // include statements.  An include statement is a line for the name
+  // followed by lines for the directory searched first and, if it was
+  // found, the file it resolved to.
+  cmDependsFortranIndexEntry* entry = 0;
+  std::string lookupName;
+  cmStdString* lookupFile = 0;
+  while(cmSystemTools::GetLineFromStream(fin, line))
+    {
+    if(line.size() < 2 || line[1] != ' ')
+      {
+      continue;
+      }
+    std::string value = line.substr(2);
+    if(line[0] == 'S')
+      {
+      entry = &index[value];
+      *entry = cmDependsFortranIndexEntry();
+      lookupFile = 0;
+      }
+    else if(!entry)
+      {
+      continue;
+      }
+    else if(line[0] == 'H')
+      {
+      cmDependsFortranReadStamp(value, entry->Stamp, 0);
+      }
+    else if(line[0] == 'P')
+      {
+      entry->Provides.insert(value);
+      }
+    else if(line[0] == 'R')
+      {
+      entry->Requires.insert(value);
+      }
+    else if(line[0] == 'I')
+      {
+      cmDependsFortranFileStamp stamp;
+      std::string include;
+      if(cmDependsFortranReadStamp(value, stamp, &include))
+        {
+        entry->Includes[include] = stamp;
+        }
+      }
+    else if(line[0] == 'L')
+      {
+      lookupName = value;
+      lookupFile = 0;
+      }
+    else if(line[0] == 'D')
+      {
+      cmDependsFortranSourceInfo::IncludeKey key(value, lookupName);
+      lookupFile = &entry->IncludeLookups[key];
+      }
+    else if(line[0] == 'F' && lookupFile)
+      {
+      *lookupFile = value;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmDependsFortranInternals::WriteModuleIndex(const char* tmpName)
+{
+  if(this->ModuleIndexChanged.empty())
+    {
+    return;
+    }
+
+  // Scans of other targets may have updated the index since it was
+  // read.  Merge the entries of this scan into the current content,
+  // then rename a complete file into place.
+  ModuleIndexMap index;
+  ReadModuleIndex(this->ModuleIndexFile.c_str(), index);
+  for(std::set<cmStdString>::const_iterator i =
+        this->ModuleIndexChanged.begin();
+      i != this->ModuleIndexChanged.end(); ++i)
+    {
+    index[*i] = this->ModuleIndex[*i];
+    }
+
+  std::ofstream fout(tmpName);
+  if(!fout)
+    {
+    return;
+    }
+  fout << FORTRAN_MODULE_INDEX_MARKER << "\n";
+  for(ModuleIndexMap::const_iterator i = index.begin(); i != index.end(); ++i)
+    {
+    cmDependsFortranIndexEntry const& entry = i->second;
+    fout << "S " << i->first << "\n";
+    fout << "H ";
+    cmDependsFortranWriteStamp(fout, entry.Stamp);
+    fout << "\n";
+    for(std::set<cmStdString>::const_iterator m = entry.Provides.begin();
+        m != entry.Provides.end(); ++m)
+      {
+      fout << "P " << *m << "\n";
+      }
+    for(std::set<cmStdString>::const_iterator m = entry.Requires.begin();
+        m != entry.Requires.end(); ++m)
+      {
+      fout << "R " << *m << "\n";
+      }
+    for(std::map<cmStdString, cmDependsFortranFileStamp>::const_iterator
+          inc = entry.Includes.begin(); inc != entry.Includes.end(); ++inc)
+      {
+      fout << "I ";
+      cmDependsFortranWriteStamp(fout, inc->second);
+      fout << " " << inc->first << "\n";
+      }
+    for(cmDependsFortranSourceInfo::IncludeLookupMap::const_iterator
+          l = entry.IncludeLookups.begin(); l != entry.IncludeLookups.end();
+        ++l)
+      {
+      fout << "L " << l->first.second << "\n";
+      fout << "D " << l->first.first << "\n";
+      if(!l->second.empty())
+        {
+        fout << "F " << l->second << "\n";
+        }
+      }
+    }
+  fout.close();
+  if(!fout ||
+     !cmSystemTools::RenameFile(tmpName, this->ModuleIndexFile.c_str()))
+    {
+    cmSystemTools::RemoveFile(tmpName);
+    }
+}
+
 //----------------------------------------------------------------------------
 cmDependsFortran::cmDependsFortran():
   PPDefinitions(0), Internal(0)
@@ -161,6 +555,33 @@ cmDependsFortran
       }
     this->PPDefinitions.push_back(def);
     }
+
+  // Parse results depend on the definitions and include path, so
+  // entries of the shared module index are keyed by them.
+  std::string context;
+  for(std::vector<std::string>::const_iterator
+        i = this->PPDefinitions.begin(); i != this->PPDefinitions.end(); ++i)
+    {
+    context += "D";
+    context += *i;
+    context += "\n";
+    }
+  for(std::vector<std::string>::const_iterator
+        i = this->IncludePath.begin(); i != this->IncludePath.end(); ++i)
+    {
+    context += "I";
+    context += *i;
+    context += "\n";
+    }
+  this->Internal->ModuleIndexContext =
+    cmSystemTools::ComputeStringMD5(context.c_str());
+  this->Internal->ModuleIndexContext += " ";
+  this->Internal->ScanTime = static_cast<long>(cmSystemTools::GetTime());
+  this->Internal->ModuleIndexFile = mf->GetHomeOutputDirectory();
+  this->Internal->ModuleIndexFile += cmake::GetCMakeFilesDirectory();
+  this->Internal->ModuleIndexFile += "/Fortran.moduleindex";
+  cmDependsFortranInternals::ReadModuleIndex(
+    this->Internal->ModuleIndexFile.c_str(), this->Internal->ModuleIndex);
 }
 
 //----------------------------------------------------------------------------
@@ -189,13 +610,24 @@ bool cmDependsFortran::WriteDependencies(const char *src, const char *obj,
   cmDependsFortranSourceInfo& info =
     this->Internal->CreateObjectInfo(obj, src);
 
+  // Use the result of an earlier parse of the same content if any.
+  if(this->Internal->FindIndexEntry(this, src, info))
+    {
+    return true;
+    }
+  cmDependsFortranSourceInfo parsed;
+
+  // Hash the source before parsing it so a change made during the
+  // parse is not recorded as parsed.
+  bool store = this->Internal->GetFileStamp(src, true) != 0;
+
   // Make a copy of the macros defined via ADD_DEFINITIONS
   std::set<std::string> ppDefines(this->PPDefinitions.begin(),
                                   this->PPDefinitions.end());
 
   // Create the parser object. The constructor takes ppMacro and info per
   // reference, so we may look into the resulting objects later.
-  cmDependsFortranParser parser(this, ppDefines, info);
+  cmDependsFortranParser parser(this, ppDefines, parsed);
 
   // Push on the starting file.
   cmDependsFortranParser_FilePush(&parser, src);
@@ -207,6 +639,14 @@ bool cmDependsFortran::WriteDependencies(const char *src, const char *obj,
     return false;
     }
 
+  // Record the result for later scans.
+  if(store)
+    {
+    this->Internal->StoreIndexEntry(src, parsed);
+    }
+  info.Provides.insert(parsed.Provides.begin(), parsed.Provides.end());
+  info.Requires.insert(parsed.Requires.begin(), parsed.Requires.end());
+  info.Includes.insert(parsed.Includes.begin(), parsed.Includes.end());
   return true;
 }
 
@@ -214,6 +654,11 @@ bool cmDependsFortran::WriteDependencies(const char *src, const char *obj,
 bool cmDependsFortran::Finalize(std::ostream& makeDepends,
                                 std::ostream& internalDepends)
 {
+  // Save the parse results of this scan for later scans.
+  std::string indexTmp = this->TargetDirectory;
+  indexTmp += "/Fortran.moduleindex.tmp";
+  this->Internal->WriteModuleIndex(indexTmp.c_str());
+
   // Prepare the module search process.
   this->LocateModules();
 
@@ -1080,7 +1525,13 @@ void cmDependsFortranParser_RuleInclude(cmDependsFortranParser* parser,
   // problem because either the source will not compile or the user
   // does not care about depending on this included source.
   std::string fullName;
-  if(parser->Self->FindIncludeFile(dir.c_str(), name, fullName))
+  bool found = parser->Self->FindIncludeFile(dir.c_str(), name, fullName);
+
+  // Record what the include resolved to so a later scan can tell
+  // whether it still would.
+  cmDependsFortranSourceInfo::IncludeKey key(dir, name);
+  parser->Info.IncludeLookups[key] = found? fullName : std::string();
+  if(found)
     {
     // Found the included file.  Save it in the set of included files.
     parser->Info.Includes.insert(fullName);
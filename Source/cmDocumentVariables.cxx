@@ -663,6 +663,18 @@ void cmDocumentVariables::DefineVariables(cmake* cm)
      "Default is ON.",false,
      "Variables That Change Behavior");
 
+  cm->DefineProperty
+    ("CMAKE_DEPENDS_STAT_CACHE", cmProperty::VARIABLE,
+     "Share file times between dependency scans in Makefile builds.",
+     "When enabled in the top-level directory, the dependency scan of "
+     "each target saves the modification times of files outside the "
+     "build tree in a file under CMakeFiles.  The scans of other targets "
+     "in the same build reuse them instead of checking each file again.  "
+     "The file is discarded when each build starts.  Do not enable this "
+     "if the build modifies files outside the build tree.  "
+     "Default is OFF.",false,
+     "Variables That Change Behavior");
+
 
   // Variables defined by CMake that describe the system
 
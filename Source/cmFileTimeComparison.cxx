@@ -11,6 +11,8 @@
 ============================================================================*/
 #include "cmFileTimeComparison.h"
 
+#include "cmSystemTools.h"
+
 // Use a hash table to avoid duplicate file time checks from disk.
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 # include <cmsys/hash_map.hxx>
@@ -21,6 +23,7 @@
 #  define cmFileTimeComparison_Type struct stat
 #  include <ctype.h>
 #  include <sys/stat.h>
+#  include <unistd.h>
 #else
 #  define cmFileTimeComparison_Type FILETIME
 #  include <windows.h>
@@ -30,12 +33,23 @@
 class cmFileTimeComparisonInternal
 {
 public:
+  cmFileTimeComparisonInternal(): PersistentDirty(false) {}
+
   // Internal comparison method.
   inline bool FileTimeCompare(const char* f1, const char* f2, int* result);
 
   bool FileTimesDiffer(const char* f1, const char* f2);
 
+  void LoadPersistentTimes(const char* fname, const char* exclude);
+  void SavePersistentTimes();
+
 private:
+  // Times of files saved across processes.
+  std::string PersistentFile;
+  std::string PersistentExclude;
+  bool PersistentDirty;
+  bool IsPersistent(const char* fname);
+
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   // Use a hash table to efficiently map from file name to modification time.
   class HashString
@@ -98,6 +112,10 @@ bool cmFileTimeComparisonInternal::Stat(const char* fname,
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   // Store the time for future use.
   this->Files[fname] = *st;
+  if(!this->PersistentFile.empty() && this->IsPersistent(fname))
+    {
+    this->PersistentDirty = true;
+    }
 #endif
 
   return true;
@@ -128,6 +146,157 @@ bool cmFileTimeComparison::FileTimesDiffer(const char* f1, const char* f2)
   return this->Internals->FileTimesDiffer(f1, f2);
 }
 
+//----------------------------------------------------------------------------
+void cmFileTimeComparison::LoadPersistentTimes(const char* fname,
+                                               const char* exclude)
+{
+  this->Internals->LoadPersistentTimes(fname, exclude);
+}
+
+//----------------------------------------------------------------------------
+void cmFileTimeComparison::SavePersistentTimes()
+{
+  this->Internals->SavePersistentTimes();
+}
+
+// The persistent file holds this header and the size of one time
+// record followed by entries of a name length, the name, and the
+// time record.
+static const char cmFileTimeComparisonMagic[] = "CMake file times 1\n";
+
+//----------------------------------------------------------------------------
+bool cmFileTimeComparisonInternal::IsPersistent(const char* fname)
+{
+  // Relative paths are relative to the build tree.
+  if(!cmSystemTools::FileIsFullPath(fname))
+    {
+    return false;
+    }
+  std::string::size_type n = this->PersistentExclude.size();
+  return !(n > 0 &&
+           strncmp(fname, this->PersistentExclude.c_str(), n) == 0 &&
+           (fname[n] == '/' || fname[n] == '\0'));
+}
+
+//----------------------------------------------------------------------------
+void cmFileTimeComparisonInternal::LoadPersistentTimes(const char* fname,
+                                                       const char* exclude)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  this->PersistentFile = fname;
+  this->PersistentExclude = exclude;
+
+  // Read the whole file at once.
+  std::ifstream fin(fname, std::ios::in | std::ios::binary);
+  if(!fin)
+    {
+    return;
+    }
+  fin.seekg(0, std::ios::end);
+  std::streamoff length = fin.tellg();
+  fin.seekg(0, std::ios::beg);
+  if(length <= 0)
+    {
+    return;
+    }
+  std::vector<char> data(static_cast<size_t>(length));
+  if(!fin.read(&data[0], length))
+    {
+    return;
+    }
+
+  // Ignore files written by another version or platform.
+  const char* p = &data[0];
+  const char* end = p + data.size();
+  size_t magic = sizeof(cmFileTimeComparisonMagic);
+  unsigned int recordSize = sizeof(cmFileTimeComparison_Type);
+  if(static_cast<size_t>(end-p) < magic + sizeof(recordSize) ||
+     memcmp(p, cmFileTimeComparisonMagic, magic) != 0 ||
+     memcmp(p + magic, &recordSize, sizeof(recordSize)) != 0)
+    {
+    return;
+    }
+  p += magic + sizeof(recordSize);
+
+  // Load entries up to the end or the first malformed one.
+  while(static_cast<size_t>(end-p) >= sizeof(unsigned int))
+    {
+    unsigned int n;
+    memcpy(&n, p, sizeof(n));
+    p += sizeof(n);
+    if(static_cast<size_t>(end-p) < n + recordSize)
+      {
+      break;
+      }
+    std::string name(p, n);
+    p += n;
+    cmFileTimeComparison_Type st;
+    memcpy(&st, p, recordSize);
+    p += recordSize;
+    if(this->IsPersistent(name.c_str()))
+      {
+      this->Files.insert(FileStatsMap::value_type(name, st));
+      }
+    }
+#else
+  (void)fname;
+  (void)exclude;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void cmFileTimeComparisonInternal::SavePersistentTimes()
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if(!this->PersistentDirty)
+    {
+    return;
+    }
+  this->PersistentDirty = false;
+
+  // Write to a file unique to this process and rename it into place.
+  cmOStringStream tmp;
+  tmp << this->PersistentFile << ".";
+#if !defined(_WIN32) || defined(__CYGWIN__)
+  tmp << static_cast<long>(getpid());
+#else
+  tmp << static_cast<long>(GetCurrentProcessId());
+#endif
+  tmp << ".tmp";
+  std::string tmpName = tmp.str();
+  std::ofstream fout(tmpName.c_str(), std::ios::out | std::ios::binary);
+  if(!fout)
+    {
+    return;
+    }
+  unsigned int recordSize = sizeof(cmFileTimeComparison_Type);
+  fout.write(cmFileTimeComparisonMagic, sizeof(cmFileTimeComparisonMagic));
+  fout.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+  for(FileStatsMap::const_iterator fi = this->Files.begin();
+      fi != this->Files.end(); ++fi)
+    {
+    if(this->IsPersistent(fi->first.c_str()))
+      {
+      unsigned int n = static_cast<unsigned int>(fi->first.size());
+      fout.write(reinterpret_cast<const char*>(&n), sizeof(n));
+      fout.write(fi->first.data(), n);
+      fout.write(reinterpret_cast<const char*>(&fi->second), recordSize);
+      }
+    }
+  fout.close();
+  if(!fout)
+    {
+    cmSystemTools::RemoveFile(tmpName.c_str());
+    return;
+    }
+  if(!cmSystemTools::RenameFile(tmpName.c_str(),
+                                this->PersistentFile.c_str()))
+    {
+    cmSystemTools::RemoveFile(tmpName.c_str());
+    }
+#endif
+}
+
 //----------------------------------------------------------------------------
 int cmFileTimeComparisonInternal::Compare(cmFileTimeComparison_Type* s1, 
                                           cmFileTimeComparison_Type* s2)
@@ -41,6 +41,21 @@ public:
    */
   bool FileTimesDiffer(const char* f1, const char* f2);
 
+  /**
+   *  Load file times saved in the given file by an earlier process
+   *  and save them back with any new times on SavePersistentTimes.
+   *  Times of files under the excluded directory, which the build
+   *  may change, are never loaded or saved.
+   */
+  void LoadPersistentTimes(const char* fname, const char* exclude);
+
+  /**
+   *  Save file times to the file given to LoadPersistentTimes if any
+   *  were added.  The file is replaced atomically so concurrent
+   *  processes each see a complete snapshot.
+   */
+  void SavePersistentTimes();
+
 protected:
   
   cmFileTimeComparisonInternal* Internals;
@@ -15,8 +15,123 @@
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 # include <cm_zlib.h>
+# include <cmsys/MD5.h>
 #endif
 
+#include <sys/stat.h>
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+//----------------------------------------------------------------------------
+// Stream buffer placed in front of the file buffer of a generated
+// file stream to hash everything written on its way to the file.
+class cmGeneratedFileStreamHasher: public std::streambuf
+{
+public:
+  cmGeneratedFileStreamHasher(std::streambuf* target): Target(target)
+    {
+    this->MD5 = cmsysMD5_New();
+    this->Reset();
+    }
+  ~cmGeneratedFileStreamHasher() { cmsysMD5_Delete(this->MD5); }
+
+  void Reset()
+    {
+    cmsysMD5_Initialize(this->MD5);
+    this->Size = 0;
+    this->setp(this->Buffer, this->Buffer + sizeof(this->Buffer));
+    }
+
+  void Finish(std::string& hash, unsigned long& size)
+    {
+    char hex[32];
+    cmsysMD5_FinalizeHex(this->MD5, hex);
+    hash.assign(hex, 32);
+    size = this->Size;
+    }
+
+protected:
+  virtual int_type overflow(int_type c)
+    {
+    if(!this->FlushBuffer())
+      {
+      return traits_type::eof();
+      }
+    if(!traits_type::eq_int_type(c, traits_type::eof()))
+      {
+      *this->pptr() = traits_type::to_char_type(c);
+      this->pbump(1);
+      }
+    return traits_type::not_eof(c);
+    }
+
+  virtual int sync()
+    {
+    if(!this->FlushBuffer())
+      {
+      return -1;
+      }
+    return this->Target->pubsync();
+    }
+
+private:
+  bool FlushBuffer()
+    {
+    std::streamsize n = this->pptr() - this->pbase();
+    if(n > 0)
+      {
+      cmsysMD5_Append(this->MD5,
+                      reinterpret_cast<unsigned char const*>(this->pbase()),
+                      static_cast<int>(n));
+      this->Size += static_cast<unsigned long>(n);
+      this->setp(this->Buffer, this->Buffer + sizeof(this->Buffer));
+      if(this->Target->sputn(this->Buffer, n) != n)
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  std::streambuf* Target;
+  cmsysMD5* MD5;
+  unsigned long Size;
+  char Buffer[4096];
+};
+#endif
+
+//----------------------------------------------------------------------------
+// Hashes of generated files recorded by LoadContentHashes and
+// SaveContentHashes.
+struct cmGeneratedFileStreamHashEntry
+{
+  std::string Hash;
+  unsigned long Size;
+  long Time;
+};
+typedef std::map<cmStdString, cmGeneratedFileStreamHashEntry>
+        cmGeneratedFileStreamHashMap;
+struct cmGeneratedFileStreamHashes
+{
+  std::string File;
+  cmGeneratedFileStreamHashMap Previous;
+  cmGeneratedFileStreamHashMap Current;
+};
+static cmGeneratedFileStreamHashes* cmGeneratedFileStreamContentHashes;
+
+//----------------------------------------------------------------------------
+static bool cmGeneratedFileStreamStat(const char* fname,
+                                      unsigned long& size, long& mtime)
+{
+  struct stat st;
+  if(stat(fname, &st) != 0)
+    {
+    return false;
+    }
+  size = static_cast<unsigned long>(st.st_size);
+  mtime = static_cast<long>(st.st_mtime);
+  return true;
+}
+
 //----------------------------------------------------------------------------
 cmGeneratedFileStream::cmGeneratedFileStream():
   cmGeneratedFileStreamBase(), Stream()
@@ -35,6 +150,7 @@ cmGeneratedFileStream::cmGeneratedFileStream(const char* name, bool quiet):
                          this->TempName.c_str());
     cmSystemTools::ReportLastSystemError("");
     }
+  this->InstallHasher();
 }
 
 //----------------------------------------------------------------------------
@@ -45,6 +161,10 @@ cmGeneratedFileStream::~cmGeneratedFileStream()
   // stream will be destroyed which will close the temporary file.
   // Finally the base destructor will be called to replace the
   // destination file.
+  if(this->is_open())
+    {
+    this->FinishHasher();
+    }
   this->Okay = (*this)?true:false;
 }
 
@@ -73,6 +193,7 @@ cmGeneratedFileStream::Open(const char* name, bool quiet, bool binaryFlag)
                          this->TempName.c_str());
     cmSystemTools::ReportLastSystemError("");
     }
+  this->InstallHasher();
   return *this;
 }
 
@@ -81,6 +202,7 @@ bool
 cmGeneratedFileStream::Close()
 {
   // Save whether the temporary output file is valid before closing.
+  this->FinishHasher();
   this->Okay = (*this)?true:false;
 
   // Close the temporary output file.
@@ -90,10 +212,55 @@ cmGeneratedFileStream::Close()
   return this->cmGeneratedFileStreamBase::Close();
 }
 
+//----------------------------------------------------------------------------
+void cmGeneratedFileStream::InstallHasher()
+{
+  this->ContentHash = "";
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Only a copy-if-different stream uses the hash, and only while the
+  // hashes of earlier output are loaded.  Other streams write straight
+  // to the file.  Replacing the stream buffer clears the stream state
+  // so restore it.
+  if(this->Hasher)
+    {
+    this->Hasher->Reset();
+    }
+  else if(this->CopyIfDifferent && cmGeneratedFileStreamContentHashes &&
+          this->is_open())
+    {
+    this->Hasher = new cmGeneratedFileStreamHasher(this->Stream::rdbuf());
+    std::ios::iostate state = this->rdstate();
+    this->std::ios::rdbuf(this->Hasher);
+    this->clear(state);
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------
+void cmGeneratedFileStream::FinishHasher()
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // Write out buffered content and take the hash of all of it.
+  if(this->Hasher)
+    {
+    this->flush();
+    this->Hasher->Finish(this->ContentHash, this->ContentSize);
+    }
+#endif
+}
+
 //----------------------------------------------------------------------------
 void cmGeneratedFileStream::SetCopyIfDifferent(bool copy_if_different)
 {
   this->CopyIfDifferent = copy_if_different;
+
+  // Start hashing if nothing has been written yet.  Otherwise the
+  // destination is compared with the file when the stream closes.
+  if(copy_if_different && !this->Hasher && this->is_open() &&
+     this->tellp() == std::streampos(0))
+    {
+    this->InstallHasher();
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -115,7 +282,10 @@ cmGeneratedFileStreamBase::cmGeneratedFileStreamBase():
   CopyIfDifferent(false),
   Okay(false),
   Compress(false),
-  CompressExtraExtension(true)
+  CompressExtraExtension(true),
+  Hasher(0),
+  ContentHash(),
+  ContentSize(0)
 {
 }
 
@@ -126,7 +296,10 @@ cmGeneratedFileStreamBase::cmGeneratedFileStreamBase(const char* name):
   CopyIfDifferent(false),
   Okay(false),
   Compress(false),
-  CompressExtraExtension(true)
+  CompressExtraExtension(true),
+  Hasher(0),
+  ContentHash(),
+  ContentSize(0)
 {
   this->Open(name);
 }
@@ -135,6 +308,9 @@ cmGeneratedFileStreamBase::cmGeneratedFileStreamBase(const char* name):
 cmGeneratedFileStreamBase::~cmGeneratedFileStreamBase()
 {
   this->Close();
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  delete this->Hasher;
+#endif
 }
 
 //----------------------------------------------------------------------------
@@ -170,11 +346,16 @@ bool cmGeneratedFileStreamBase::Close()
     }
 
   // Only consider replacing the destination file if no error
-  // occurred.
-  if(!this->Name.empty() &&
-    this->Okay &&
-    (!this->CopyIfDifferent ||
-     cmSystemTools::FilesDiffer(this->TempName.c_str(), resname.c_str())))
+  // occurred.  Avoid reading the destination to compare it when the
+  // hash recorded for it decides the question.
+  bool differ = true;
+  if(this->CopyIfDifferent && !this->Name.empty() && this->Okay &&
+     !this->CheckContentHash(resname.c_str(), differ))
+    {
+    differ =
+      cmSystemTools::FilesDiffer(this->TempName.c_str(), resname.c_str());
+    }
+  if(!this->Name.empty() && this->Okay && differ)
     {
     // The destination is to be replaced.  Rename the temporary to the
     // destination atomically.
@@ -197,12 +378,129 @@ bool cmGeneratedFileStreamBase::Close()
 
   // Else, the destination was not replaced.
   //
+  // Remember what the destination holds now.
+  if(this->CopyIfDifferent && !this->Name.empty() && this->Okay)
+    {
+    this->RecordContentHash(resname.c_str());
+    }
+  this->ContentHash = "";
+
   // Always delete the temporary file. We never want it to stay around.
   cmSystemTools::RemoveFile(this->TempName.c_str());
 
   return replaced;
 }
 
+//----------------------------------------------------------------------------
+bool cmGeneratedFileStreamBase::CheckContentHash(const char* resname,
+                                                 bool& differ)
+{
+  cmGeneratedFileStreamHashes* hashes = cmGeneratedFileStreamContentHashes;
+  if(!hashes || this->Compress || this->ContentHash.empty())
+    {
+    return false;
+    }
+
+  // Look for the hash of what this run or the previous one wrote.
+  cmGeneratedFileStreamHashMap::const_iterator e =
+    hashes->Current.find(resname);
+  if(e == hashes->Current.end())
+    {
+    e = hashes->Previous.find(resname);
+    if(e == hashes->Previous.end())
+      {
+      return false;
+      }
+    }
+
+  // The hash is good only if the file has not been touched since.
+  unsigned long size;
+  long mtime;
+  if(!cmGeneratedFileStreamStat(resname, size, mtime))
+    {
+    differ = true;
+    return true;
+    }
+  if(size != e->second.Size || mtime != e->second.Time)
+    {
+    return false;
+    }
+  differ = (size != this->ContentSize || e->second.Hash != this->ContentHash);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmGeneratedFileStreamBase::RecordContentHash(const char* resname)
+{
+  cmGeneratedFileStreamHashes* hashes = cmGeneratedFileStreamContentHashes;
+  if(!hashes || this->Compress || this->ContentHash.empty())
+    {
+    return;
+    }
+  cmGeneratedFileStreamHashEntry entry;
+  if(cmGeneratedFileStreamStat(resname, entry.Size, entry.Time) &&
+     entry.Size == this->ContentSize)
+    {
+    entry.Hash = this->ContentHash;
+    hashes->Current[resname] = entry;
+    }
+  else
+    {
+    hashes->Current.erase(resname);
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmGeneratedFileStream::LoadContentHashes(const char* fname)
+{
+  delete cmGeneratedFileStreamContentHashes;
+  cmGeneratedFileStreamContentHashes = new cmGeneratedFileStreamHashes;
+  cmGeneratedFileStreamHashes* hashes = cmGeneratedFileStreamContentHashes;
+  hashes->File = fname;
+
+  // Each line holds the hash, size, and time of one file and its name.
+  std::ifstream fin(fname);
+  std::string line;
+  while(cmSystemTools::GetLineFromStream(fin, line))
+    {
+    std::string::size_type t = line.find(' ', 33);
+    std::string::size_type n =
+      t == std::string::npos? t : line.find(' ', t+1);
+    if(line.size() < 34 || line[32] != ' ' || n == std::string::npos)
+      {
+      continue;
+      }
+    cmGeneratedFileStreamHashEntry entry;
+    entry.Hash = line.substr(0, 32);
+    entry.Size = strtoul(line.c_str()+33, 0, 10);
+    entry.Time = strtol(line.c_str()+t+1, 0, 10);
+    hashes->Previous[line.substr(n+1)] = entry;
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmGeneratedFileStream::SaveContentHashes()
+{
+  cmGeneratedFileStreamHashes* hashes = cmGeneratedFileStreamContentHashes;
+  if(!hashes)
+    {
+    return;
+    }
+  cmGeneratedFileStreamContentHashes = 0;
+
+  // Only files generated by this run are kept.
+  {
+  cmGeneratedFileStream fout(hashes->File.c_str());
+  for(cmGeneratedFileStreamHashMap::const_iterator e =
+        hashes->Current.begin(); e != hashes->Current.end(); ++e)
+    {
+    fout << e->second.Hash << " " << e->second.Size << " "
+         << e->second.Time << " " << e->first << "\n";
+    }
+  }
+  delete hashes;
+}
+
 //----------------------------------------------------------------------------
 #ifdef CMAKE_BUILD_WITH_CMAKE
 int cmGeneratedFileStreamBase::CompressFile(const char* oldname,
@@ -18,6 +18,8 @@
 # pragma set woff 1375 /* base class destructor not virtual */
 #endif
 
+class cmGeneratedFileStreamHasher;
+
 // This is the first base class of cmGeneratedFileStream.  It will be
 // created before and destroyed after the ofstream portion and can
 // therefore be used to manage the temporary file.
@@ -47,6 +49,14 @@ protected:
   // Internal file compression implementation.
   int CompressFile(const char* oldname, const char* newname);
 
+  // Decide from the recorded hash of the previous output whether the
+  // destination differs from the new content.  Returns false if the
+  // files must be compared.
+  bool CheckContentHash(const char* resname, bool& differ);
+
+  // Record the hash of the content now in the destination.
+  void RecordContentHash(const char* resname);
+
   // The name of the final destination file for the output.
   std::string Name;
 
@@ -64,6 +74,11 @@ protected:
 
   // Whether the destionation file is compressed
   bool CompressExtraExtension;
+
+  // Hash of the content written through the stream, if available.
+  cmGeneratedFileStreamHasher* Hasher;
+  std::string ContentHash;
+  unsigned long ContentSize;
 };
 
 /** \class cmGeneratedFileStream
@@ -121,7 +136,8 @@ public:
   bool Close();
 
   /**
-   * Set whether copy-if-different is done.
+   * Set whether copy-if-different is done.  Set it before writing so
+   * the output can be compared with the destination by its hash.
    */
   void SetCopyIfDifferent(bool copy_if_different);
 
@@ -141,7 +157,24 @@ public:
    */
   void SetName(const char* fname);
 
+  /**
+   * Load the hashes recorded for files generated by an earlier run.
+   * Until SaveContentHashes is called, copy-if-different streams use
+   * them to compare their content with the destination file without
+   * reading it, and record the hashes of the files they produce.
+   */
+  static void LoadContentHashes(const char* fname);
+
+  /**
+   * Save the hashes recorded since LoadContentHashes was called to the
+   * file it was given and stop recording.
+   */
+  static void SaveContentHashes();
+
 private:
+  void InstallHasher();
+  void FinishHasher();
+
   cmGeneratedFileStream(cmGeneratedFileStream const&); // not implemented
 };
 
@@ -904,6 +904,11 @@ void cmGlobalGenerator::Generate()
     this->ExtraGenerator->Generate();
     }
 
+  if(this->CMakeInstance->GetTraceStats())
+    {
+    this->WriteTraceStats();
+    }
+
   this->CMakeInstance->UpdateProgress("Generating done", -1);
 }
 
@@ -2178,6 +2183,31 @@ void cmGlobalGenerator::WriteSummary()
     }
 }
 
+//----------------------------------------------------------------------------
+void cmGlobalGenerator::WriteTraceStats()
+{
+  cmLocalGenerator::ConvertCacheStats total;
+  for(std::vector<cmLocalGenerator*>::const_iterator
+        li = this->LocalGenerators.begin();
+      li != this->LocalGenerators.end(); ++li)
+    {
+    cmLocalGenerator::ConvertCacheStats const& s =
+      (*li)->GetConvertCacheStats();
+    total.ConvertHits += s.ConvertHits;
+    total.ConvertMisses += s.ConvertMisses;
+    total.RelativeHits += s.RelativeHits;
+    total.RelativeMisses += s.RelativeMisses;
+    }
+  cmOStringStream msg;
+  msg << "Path conversion cache: "
+      << total.ConvertHits << " hits, "
+      << total.ConvertMisses << " misses\n"
+      << "Relative path cache: "
+      << total.RelativeHits << " hits, "
+      << total.RelativeMisses << " misses";
+  cmSystemTools::Message(msg.str().c_str());
+}
+
 //----------------------------------------------------------------------------
 void cmGlobalGenerator::WriteSummary(cmTarget* target)
 {
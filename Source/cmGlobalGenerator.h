@@ -341,6 +341,8 @@ private:
   void WriteSummary();
   void WriteSummary(cmTarget* target);
 
+  void WriteTraceStats();
+
   cmExternalMakefileProjectGenerator* ExtraGenerator;
 
   // track files replaced during a Generate
@@ -25,6 +25,7 @@ cmGlobalUnixMakefileGenerator3::cmGlobalUnixMakefileGenerator3()
   this->FindMakeProgramFile = "CMakeUnixFindMake.cmake";
   this->ToolSupportsColor = true;
   this->ForceVerboseMakefiles = false;
+  this->LastProgressMark = 0;
 
 #if defined(_WIN32) || defined(__VMS)
   this->UseLinkScript = false;
@@ -165,6 +166,16 @@ void cmGlobalUnixMakefileGenerator3::Generate()
     {
     pmi->second.WriteProgressVariables(total, current);
     }
+  this->LastProgressMark = 0;
+  for(ProgressMapType::const_iterator pmi = this->ProgressMap.begin();
+      pmi != this->ProgressMap.end(); ++pmi)
+    {
+    std::vector<int> const& marks = pmi->second.Marks;
+    if(!marks.empty() && marks.back() > this->LastProgressMark)
+      {
+      this->LastProgressMark = marks.back();
+      }
+    }
   for(unsigned int i = 0; i < this->LocalGenerators.size(); ++i)
     {
     cmLocalUnixMakefileGenerator3 *lg = 
@@ -174,7 +185,8 @@ void cmGlobalUnixMakefileGenerator3::Generate()
     markFileName += cmake::GetCMakeFilesDirectory();
     markFileName += "/progress.marks";
     cmGeneratedFileStream markFile(markFileName.c_str());
-    markFile << this->CountProgressMarksInAll(lg) << "\n";
+    markFile << this->CountProgressMarksInAll(lg) << "\n"
+             << this->LastProgressMark << "\n";
     }
   
   // write the main makefile
@@ -265,6 +277,8 @@ void cmGlobalUnixMakefileGenerator3::WriteMainCMakefile()
     this->GetCMakeInstance()->GetHomeOutputDirectory();
   cmakefileName += cmake::GetCMakeFilesDirectory();
   cmakefileName += "/Makefile.cmake";
+  cmSystemTools::RemoveFile(
+    cmake::GetBuildSystemManifest(cmakefileName.c_str()).c_str());
   cmGeneratedFileStream cmakefileStream(cmakefileName.c_str());
   if(!cmakefileStream)
     {
@@ -314,19 +328,22 @@ void cmGlobalUnixMakefileGenerator3::WriteMainCMakefile()
   cache += "/CMakeCache.txt";
 
   // Save the list to the cmake file.
-  cmakefileStream
-    << "# The top level Makefile was generated from the following files:\n"
-    << "SET(CMAKE_MAKEFILE_DEPENDS\n"
-    << "  \"" 
-    << lg->Convert(cache.c_str(),
-                   cmLocalGenerator::START_OUTPUT).c_str() << "\"\n";
+  std::vector<std::string> depends;
+  depends.push_back(lg->Convert(cache.c_str(),
+                                cmLocalGenerator::START_OUTPUT));
   for(std::vector<std::string>::const_iterator i = lfiles.begin();
       i !=  lfiles.end(); ++i)
     {
-    cmakefileStream
-      << "  \"" 
-      << lg->Convert(i->c_str(), cmLocalGenerator::START_OUTPUT).c_str()
-      << "\"\n";
+    depends.push_back(lg->Convert(i->c_str(),
+                                  cmLocalGenerator::START_OUTPUT));
+    }
+  cmakefileStream
+    << "# The top level Makefile was generated from the following files:\n"
+    << "SET(CMAKE_MAKEFILE_DEPENDS\n";
+  for(std::vector<std::string>::const_iterator i = depends.begin();
+      i != depends.end(); ++i)
+    {
+    cmakefileStream << "  \"" << i->c_str() << "\"\n";
     }
   cmakefileStream
     << "  )\n\n";
@@ -337,18 +354,23 @@ void cmGlobalUnixMakefileGenerator3::WriteMainCMakefile()
   check += "/cmake.check_cache";
 
   // Set the corresponding makefile in the cmake file.
+  std::vector<std::string> outputs;
+  outputs.push_back(lg->Convert(makefileName.c_str(),
+                                cmLocalGenerator::START_OUTPUT));
+  outputs.push_back(lg->Convert(check.c_str(),
+                                cmLocalGenerator::START_OUTPUT));
   cmakefileStream
     << "# The corresponding makefile is:\n"
-    << "SET(CMAKE_MAKEFILE_OUTPUTS\n"
-    << "  \"" 
-    << lg->Convert(makefileName.c_str(),
-                   cmLocalGenerator::START_OUTPUT).c_str() << "\"\n"
-    << "  \"" 
-    << lg->Convert(check.c_str(),
-                   cmLocalGenerator::START_OUTPUT).c_str() << "\"\n";
+    << "SET(CMAKE_MAKEFILE_OUTPUTS\n";
+  for(std::vector<std::string>::const_iterator i = outputs.begin();
+      i != outputs.end(); ++i)
+    {
+    cmakefileStream << "  \"" << i->c_str() << "\"\n";
+    }
   cmakefileStream << "  )\n\n";
 
   // CMake must rerun if a byproduct is missing.
+  std::vector<std::string> products;
   {
   cmakefileStream
     << "# Byproducts of CMake generate step:\n"
@@ -358,9 +380,9 @@ void cmGlobalUnixMakefileGenerator3::WriteMainCMakefile()
   for(std::vector<std::string>::const_iterator k = outfiles.begin();
       k != outfiles.end(); ++k)
     {
-    cmakefileStream << "  \"" <<
-      lg->Convert(k->c_str(),cmLocalGenerator::HOME_OUTPUT).c_str()
-                    << "\"\n";
+    products.push_back(
+      lg->Convert(k->c_str(),cmLocalGenerator::HOME_OUTPUT));
+    cmakefileStream << "  \"" << products.back().c_str() << "\"\n";
     }
 
   // add in all the directory information files
@@ -372,15 +394,23 @@ void cmGlobalUnixMakefileGenerator3::WriteMainCMakefile()
     tmpStr = lg->GetMakefile()->GetStartOutputDirectory();
     tmpStr += cmake::GetCMakeFilesDirectory();
     tmpStr += "/CMakeDirectoryInformation.cmake";
-    cmakefileStream << "  \"" << 
-      lg->Convert(tmpStr.c_str(),cmLocalGenerator::HOME_OUTPUT).c_str() 
-                    << "\"\n";
+    products.push_back(
+      lg->Convert(tmpStr.c_str(),cmLocalGenerator::HOME_OUTPUT));
+    cmakefileStream << "  \"" << products.back().c_str() << "\"\n";
     }
   cmakefileStream << "  )\n\n";
   }
 
   this->WriteMainCMakefileLanguageRules(cmakefileStream, 
                                         this->LocalGenerators);
+
+  // Let the check-build-system step compare the same files without
+  // reading this file.
+  if(cmakefileStream.Close())
+    {
+    cmake::WriteBuildSystemManifest(cmakefileName.c_str(), products,
+                                    depends, outputs);
+    }
 }
 
 void cmGlobalUnixMakefileGenerator3
@@ -717,10 +747,23 @@ cmGlobalUnixMakefileGenerator3
         << localName << "\n\n";
     
       commands.clear();        
-      makeTargetName = localName;
-      makeTargetName += "/depend";
-      commands.push_back(lg->GetRecursiveMakeCall
-                         (makefileName.c_str(),makeTargetName.c_str()));
+
+      // Scan dependencies directly when the depend rule has nothing
+      // for make to bring up to date.  This saves reading the target's
+      // build.make, flags.make and depend.make one extra time.
+      DependCommandMapType::const_iterator dci =
+        this->DependCommands.find(&t->second);
+      if(dci != this->DependCommands.end())
+        {
+        commands.push_back(dci->second);
+        }
+      else
+        {
+        makeTargetName = localName;
+        makeTargetName += "/depend";
+        commands.push_back(lg->GetRecursiveMakeCall
+                           (makefileName.c_str(),makeTargetName.c_str()));
+        }
 
       // add requires if we need it for this generator
       if (needRequiresStep)
@@ -792,7 +835,8 @@ cmGlobalUnixMakefileGenerator3
       //
       std::set<cmTarget *> emitted;
       progCmd << " " 
-              << this->CountProgressMarksInTarget(&t->second, emitted);
+              << this->CountProgressMarksInTarget(&t->second, emitted)
+              << " " << this->LastProgressMark;
       commands.push_back(progCmd.str());
       }
       std::string tmp = cmake::GetCMakeFilesDirectoryPostSlash();
@@ -910,6 +954,17 @@ cmGlobalUnixMakefileGenerator3::RecordTargetProgress(
   tp.VariableFile = tg->GetProgressFileNameFull();
 }
 
+//----------------------------------------------------------------------------
+void
+cmGlobalUnixMakefileGenerator3::RecordTargetDependCommand(
+  cmMakefileTargetGenerator* tg)
+{
+  if(!tg->GetDependCommand().empty())
+    {
+    this->DependCommands[tg->GetTarget()] = tg->GetDependCommand();
+    }
+}
+
 //----------------------------------------------------------------------------
 bool
 cmGlobalUnixMakefileGenerator3::ProgressMapCompare
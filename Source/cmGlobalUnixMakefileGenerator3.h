@@ -112,6 +112,9 @@ public:
   /** Record per-target progress information.  */
   void RecordTargetProgress(cmMakefileTargetGenerator* tg);
 
+  /** Record the dependency scanning command of a target.  */
+  void RecordTargetDependCommand(cmMakefileTargetGenerator* tg);
+
   /**
    * If true, the CMake variable CMAKE_VERBOSE_MAKEFILES doesn't have effect
    * anymore. Set it to true when writing a generator where short output
@@ -185,6 +188,15 @@ protected:
                    ProgressMapCompare> ProgressMapType;
   ProgressMapType ProgressMap;
 
+  // The largest mark any target reports.  Building part of the tree
+  // still reports marks numbered for the whole tree.
+  int LastProgressMark;
+
+  // Store per-target dependency scanning commands that may be run
+  // without invoking make on the target's build.make.
+  typedef std::map<cmTarget*, std::string> DependCommandMapType;
+  DependCommandMapType DependCommands;
+
   size_t CountProgressMarksInTarget(cmTarget* target,
                                     std::set<cmTarget*>& emitted);
   size_t CountProgressMarksInAll(cmLocalUnixMakefileGenerator3* lg);
@@ -17,6 +17,11 @@
 #include "cmVersion.h"
 
 #include <cmsys/RegularExpression.hxx>
+#include <cmsys/auto_ptr.hxx>
+
+#if !defined(_WIN32) || defined(__CYGWIN__)
+# include <sys/stat.h>
+#endif
 
 #ifdef __BORLANDC__
 # pragma warn -8060 /* possibly incorrect assignment */
@@ -312,3 +317,103 @@ std::ostream& operator<<(std::ostream& os, cmListFileContext const& lfc)
     }
   return os;
 }
+
+//----------------------------------------------------------------------------
+struct cmListFileCache::Stamp
+{
+  Stamp(): Time(0), TimeNSec(0), Size(0) {}
+  bool operator==(Stamp const& r) const
+    {
+    return (this->Time == r.Time && this->TimeNSec == r.TimeNSec &&
+            this->Size == r.Size);
+    }
+  long Time;
+  long TimeNSec;
+  unsigned long Size;
+};
+
+//----------------------------------------------------------------------------
+struct cmListFileCache::Entry
+{
+  std::string Path;
+  Stamp FileStamp;
+  cmListFile File;
+};
+
+//----------------------------------------------------------------------------
+cmListFileCache::cmListFileCache()
+{
+}
+
+//----------------------------------------------------------------------------
+cmListFileCache::~cmListFileCache()
+{
+  for(FileMap::iterator i = this->Files.begin(); i != this->Files.end(); ++i)
+    {
+    delete i->second;
+    }
+  for(std::vector<Entry*>::iterator i = this->Retired.begin();
+      i != this->Retired.end(); ++i)
+    {
+    delete *i;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmListFileCache::GetStamp(const char* path, Stamp& stamp)
+{
+#if !defined(_WIN32) || defined(__CYGWIN__)
+  struct stat st;
+  if(::stat(path, &st) != 0)
+    {
+    return false;
+    }
+  stamp.Time = static_cast<long>(st.st_mtime);
+# if cmsys_STAT_HAS_ST_MTIM
+  stamp.TimeNSec = static_cast<long>(st.st_mtim.tv_nsec);
+# endif
+  stamp.Size = static_cast<unsigned long>(st.st_size);
+#else
+  if(!cmSystemTools::FileExists(path))
+    {
+    return false;
+    }
+  stamp.Time = cmSystemTools::ModifiedTime(path);
+  stamp.Size = cmSystemTools::FileLength(path);
+#endif
+  return true;
+}
+
+//----------------------------------------------------------------------------
+cmListFile const* cmListFileCache::GetFile(const char* path, cmMakefile* mf)
+{
+  Stamp stamp;
+  if(!GetStamp(path, stamp))
+    {
+    return 0;
+    }
+
+  FileMap::iterator i = this->Files.find(path);
+  if(i != this->Files.end())
+    {
+    if(i->second->FileStamp == stamp)
+      {
+      return &i->second->File;
+      }
+    this->Retired.push_back(i->second);
+    this->Files.erase(i);
+    }
+
+  // Parse with the file name owned by the entry so that argument file
+  // paths remain valid as long as the parsed functions.
+  cmsys::auto_ptr<Entry> entry(new Entry);
+  entry->Path = path;
+  entry->FileStamp = stamp;
+  if(!entry->File.ParseFile(entry->Path.c_str(), false, mf))
+    {
+    return 0;
+    }
+  cmListFile const* lf = &entry->File;
+  this->Files[path] = entry.release();
+  return lf;
+}
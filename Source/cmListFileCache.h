@@ -22,7 +22,8 @@
  */
 
 class cmMakefile;
- 
+class cmCommand;
+
 struct cmListFileArgument
 {
   cmListFileArgument(): Value(), Quoted(false), FilePath(0), Line(0) {}
@@ -57,7 +58,15 @@ std::ostream& operator<<(std::ostream&, cmListFileContext const&);
 
 struct cmListFileFunction: public cmListFileContext
 {
+  cmListFileFunction(): Command(0), CommandGeneration(0) {}
   std::vector<cmListFileArgument> Arguments;
+
+  // Command prototype resolved for this call by cmake::ResolveCommand.
+  // It is valid only while the command table generation matches, so
+  // code that reuses an object for a call to another command must
+  // reset or copy these as well.
+  mutable cmCommand* Command;
+  mutable unsigned long CommandGeneration;
 };
 
 class cmListFileBacktrace: public std::vector<cmListFileContext> {};
@@ -76,4 +85,35 @@ struct cmListFile
   std::vector<cmListFileFunction> Functions;
 };
 
+/** \class cmListFileCache
+ * \brief Hold parsed list files for reuse by later reads.
+ *
+ * Files read with include() or find_package() are parsed once and
+ * shared by every cmMakefile of a cmake instance until the file
+ * changes on disk.  The parsed functions must not be modified.
+ */
+class cmListFileCache
+{
+public:
+  cmListFileCache();
+  ~cmListFileCache();
+
+  /** Get the parsed content of the given file.  The file is parsed
+      only if it has not been seen before or if its modification time
+      or size changed since it was last parsed.  Returns 0 if the file
+      cannot be read or contains a parse error.  */
+  cmListFile const* GetFile(const char* path, cmMakefile* mf);
+
+private:
+  struct Stamp;
+  struct Entry;
+  static bool GetStamp(const char* path, Stamp& stamp);
+  typedef std::map<cmStdString, Entry*> FileMap;
+  FileMap Files;
+
+  // Entries replaced after their file changed on disk.  Commands from
+  // them may still be executing so they are kept until destruction.
+  std::vector<Entry*> Retired;
+};
+
 #endif
@@ -2161,11 +2161,56 @@ const char* cmLocalGenerator::GetRelativeRootPath(RelativeRoot relroot)
   return 0;
 }
 
+//----------------------------------------------------------------------------
+int cmLocalGenerator::GetConvertMode(int root, OutputFormat output,
+                                     bool optional) const
+{
+  int mode = root;
+  mode |= static_cast<int>(output) << 4;
+  if(!optional || this->UseRelativePaths)
+    {
+    mode |= 1 << 6;
+    }
+  if(this->LinkScriptShell)
+    {
+    mode |= 1 << 7;
+    }
+  if(cmSystemTools::GetForceUnixPaths())
+    {
+    mode |= 1 << 8;
+    }
+  return mode;
+}
+
 //----------------------------------------------------------------------------
 std::string cmLocalGenerator::Convert(const char* source,
                                       RelativeRoot relative,
                                       OutputFormat output,
                                       bool optional)
+{
+  if(relative == FULL)
+    {
+    return this->ConvertInternal(source, relative, output, optional);
+    }
+  ConvertKey key(this->GetConvertMode(relative, output, optional), source);
+  ConvertCacheType::const_iterator i = this->ConvertCache.find(key);
+  if(i != this->ConvertCache.end())
+    {
+    ++this->ConvertStats.ConvertHits;
+    return i->second;
+    }
+  ++this->ConvertStats.ConvertMisses;
+  std::string result =
+    this->ConvertInternal(source, relative, output, optional);
+  this->ConvertCache[key] = result;
+  return result;
+}
+
+//----------------------------------------------------------------------------
+std::string cmLocalGenerator::ConvertInternal(const char* source,
+                                              RelativeRoot relative,
+                                              OutputFormat output,
+                                              bool optional)
 {
   // Make sure the relative path conversion components are set.
   if(!this->PathConversionsSetup)
@@ -2255,6 +2300,34 @@ std::string cmLocalGenerator::Convert(RelativeRoot remote,
                                       const char* local,
                                       OutputFormat output,
                                       bool optional)
+{
+  // Distinguish these modes from those of the other overload.
+  ConvertKey key(this->GetConvertMode(8 + remote, output, optional),
+                 local? local : "");
+  if(local)
+    {
+    ConvertCacheType::const_iterator i = this->ConvertCache.find(key);
+    if(i != this->ConvertCache.end())
+      {
+      ++this->ConvertStats.ConvertHits;
+      return i->second;
+      }
+    }
+  ++this->ConvertStats.ConvertMisses;
+  std::string result =
+    this->ConvertInternal(remote, local, output, optional);
+  if(local)
+    {
+    this->ConvertCache[key] = result;
+    }
+  return result;
+}
+
+//----------------------------------------------------------------------------
+std::string cmLocalGenerator::ConvertInternal(RelativeRoot remote,
+                                              const char* local,
+                                              OutputFormat output,
+                                              bool optional)
 {
   const char* remotePath = this->GetRelativeRootPath(remote);
 
@@ -2348,6 +2421,48 @@ static bool cmLocalGeneratorNotAbove(const char* a, const char* b)
 std::string
 cmLocalGenerator::ConvertToRelativePath(const std::vector<std::string>& local,
                                         const char* in_remote, bool force)
+{
+  // Memoize conversions relative to the directories of this generator.
+  // Other local paths are given by callers that manage their own.
+  int root;
+  if(&local == &this->HomeDirectoryComponents)
+    {
+    root = HOME;
+    }
+  else if(&local == &this->StartDirectoryComponents)
+    {
+    root = START;
+    }
+  else if(&local == &this->HomeOutputDirectoryComponents)
+    {
+    root = HOME_OUTPUT;
+    }
+  else if(&local == &this->StartOutputDirectoryComponents)
+    {
+    root = START_OUTPUT;
+    }
+  else
+    {
+    return this->ConvertToRelativePathInternal(local, in_remote, force);
+    }
+  ConvertKey key(force? (root | 8) : root, in_remote);
+  ConvertCacheType::const_iterator i = this->RelativePathCache.find(key);
+  if(i != this->RelativePathCache.end())
+    {
+    ++this->ConvertStats.RelativeHits;
+    return i->second;
+    }
+  ++this->ConvertStats.RelativeMisses;
+  std::string result =
+    this->ConvertToRelativePathInternal(local, in_remote, force);
+  this->RelativePathCache[key] = result;
+  return result;
+}
+
+//----------------------------------------------------------------------------
+std::string cmLocalGenerator
+::ConvertToRelativePathInternal(const std::vector<std::string>& local,
+                                const char* in_remote, bool force)
 {
   // The path should never be quoted.
   assert(in_remote[0] != '\"');
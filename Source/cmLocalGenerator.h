@@ -14,6 +14,10 @@
 
 #include "cmStandardIncludes.h"
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+# include <cmsys/hash_map.hxx>
+#endif
+
 class cmMakefile;
 class cmGlobalGenerator;
 class cmTarget;
@@ -266,6 +270,19 @@ public:
   std::string ConvertToRelativePath(const std::vector<std::string>& local,
                                     const char* remote, bool force=false);
 
+  /** Hit and miss counts of the path conversion caches.  */
+  struct ConvertCacheStats
+  {
+    ConvertCacheStats(): ConvertHits(0), ConvertMisses(0),
+                         RelativeHits(0), RelativeMisses(0) {}
+    unsigned long ConvertHits;
+    unsigned long ConvertMisses;
+    unsigned long RelativeHits;
+    unsigned long RelativeMisses;
+  };
+  ConvertCacheStats const& GetConvertCacheStats() const
+    { return this->ConvertStats; }
+
   /**
    * Get the relative path from the generator output directory to a
    * per-target support directory.
@@ -420,6 +437,49 @@ protected:
 private:
   std::string ConvertToOutputForExistingCommon(const char* remote,
                                                std::string const& result);
+
+  std::string ConvertInternal(const char* remote, RelativeRoot local,
+                              OutputFormat output, bool optional);
+  std::string ConvertInternal(RelativeRoot remote, const char* local,
+                              OutputFormat output, bool optional);
+  std::string
+  ConvertToRelativePathInternal(const std::vector<std::string>& local,
+                                const char* remote, bool force);
+  int GetConvertMode(int root, OutputFormat output, bool optional) const;
+
+  // Memoized path conversions.  The mode holds every setting the
+  // result depends on.  Conversions to full paths depend on the
+  // working directory and are not memoized.
+  struct ConvertKey
+  {
+    ConvertKey(int mode, const char* path): Mode(mode), Path(path) {}
+    int Mode;
+    cmStdString Path;
+    bool operator==(ConvertKey const& r) const
+      { return this->Mode == r.Mode && this->Path == r.Path; }
+    bool operator<(ConvertKey const& r) const
+      {
+      return (this->Mode < r.Mode ||
+              (this->Mode == r.Mode && this->Path < r.Path));
+      }
+  };
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  struct ConvertKeyHash
+  {
+    size_t operator()(ConvertKey const& k) const
+      {
+      return this->h(k.Path.c_str()) ^ static_cast<size_t>(k.Mode);
+      }
+    cmsys::hash<const char*> h;
+  };
+  typedef cmsys::hash_map<ConvertKey, cmStdString,
+                          ConvertKeyHash> ConvertCacheType;
+#else
+  typedef std::map<ConvertKey, cmStdString> ConvertCacheType;
+#endif
+  ConvertCacheType ConvertCache;
+  ConvertCacheType RelativePathCache;
+  ConvertCacheStats ConvertStats;
 };
 
 #endif
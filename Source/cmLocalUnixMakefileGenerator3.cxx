@@ -135,6 +135,7 @@ void cmLocalUnixMakefileGenerator3::Generate()
       {
       tg->WriteRuleFiles();
       gg->RecordTargetProgress(tg.get());
+      gg->RecordTargetDependCommand(tg.get());
       }
     }
 
@@ -790,6 +791,16 @@ void cmLocalUnixMakefileGenerator3
 
   std::vector<std::string> no_depends;
   std::vector<std::string> commands;
+
+  // A new build starts here so discard file times shared by the
+  // dependency scans of the previous build.
+  std::string statCache = this->GetDependStatCacheFile();
+  if(!statCache.empty())
+    {
+    std::string removeRule = "$(CMAKE_COMMAND) -E remove -f ";
+    removeRule += this->Convert(statCache.c_str(), HOME_OUTPUT, SHELL);
+    commands.push_back(removeRule);
+    }
   commands.push_back(runRule);
   if(this->Parent)
     {
@@ -1336,6 +1347,16 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(const char* tgtInfo,
     cmSystemTools::Error("Target DependInfo.cmake file not found");
     }
 
+  // Share file times with the other dependency scans of this build.
+  cmFileTimeComparison* ftc =
+    this->GlobalGenerator->GetCMakeInstance()->GetFileComparison();
+  if(const char* statCache =
+     this->Makefile->GetDefinition("CMAKE_DEPENDS_STAT_CACHE_FILE"))
+    {
+    ftc->LoadPersistentTimes(statCache,
+                             this->Makefile->GetHomeOutputDirectory());
+    }
+
   // Check if any multiple output pairs have a missing file.
   this->CheckMultipleOutputs(verbose);
 
@@ -1348,8 +1369,6 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(const char* tgtInfo,
   // happen when a new source file is added and CMake regenerates the
   // project but no other sources were touched.
   bool needRescanDependInfo = false;
-  cmFileTimeComparison* ftc =
-    this->GlobalGenerator->GetCMakeInstance()->GetFileComparison();
   {
   int result;
   if(!ftc->FileTimeCompare(internalDependFile.c_str(), tgtInfo, &result) ||
@@ -1401,6 +1420,7 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(const char* tgtInfo,
     cmDependsC checker;
     checker.SetVerbose(verbose);
     checker.SetFileComparison(ftc);
+    checker.SetNeedValidDependencies(needRescanDependInfo);
     // cmDependsC::Check() fills the vector validDependencies() with the
     // dependencies for those files where they are still valid, i.e. neither
     // the files themselves nor any files they depend on have changed.
@@ -1416,6 +1436,7 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(const char* tgtInfo,
                                             validDependencies);
     }
 
+  bool result = true;
   if(needRescanDependInfo || needRescanDirInfo || needRescanDependencies)
     {
     // The dependencies must be regenerated.
@@ -1432,11 +1453,28 @@ bool cmLocalUnixMakefileGenerator3::UpdateDependencies(const char* tgtInfo,
     fprintf(stdout, "%s\n", message.c_str());
 #endif
 
-    return this->ScanDependencies(dir.c_str(), validDependencies);
+    result = this->ScanDependencies(dir.c_str(), validDependencies);
     }
 
-  // The dependencies are already up-to-date.
-  return true;
+  ftc->SavePersistentTimes();
+  return result;
+}
+
+//----------------------------------------------------------------------------
+std::string cmLocalUnixMakefileGenerator3::GetDependStatCacheFile()
+{
+  // The top-level setting applies to the whole build tree because
+  // every directory's Makefile discards the file when a build starts.
+  cmMakefile* mf =
+    this->GlobalGenerator->GetLocalGenerators()[0]->GetMakefile();
+  if(!mf->IsOn("CMAKE_DEPENDS_STAT_CACHE"))
+    {
+    return "";
+    }
+  std::string statCache = mf->GetHomeOutputDirectory();
+  statCache += cmake::GetCMakeFilesDirectory();
+  statCache += "/DependStatCache.bin";
+  return statCache;
 }
 
 //----------------------------------------------------------------------------
@@ -1558,6 +1596,10 @@ cmLocalUnixMakefileGenerator3
       }
     }
 
+  // Index the new dependencies for the next check.
+  internalRuleFileStream.Close();
+  cmDepends::WriteInternalIndex(internalRuleFileNameFull.c_str());
+
   return true;
 }
 
@@ -1840,6 +1882,8 @@ void cmLocalUnixMakefileGenerator3::ClearDependencies(cmMakefile* mf,
     // regeneration.
     std::string internalDependFile = dir + "/depend.internal";
     cmSystemTools::RemoveFile(internalDependFile.c_str());
+    cmSystemTools::RemoveFile(
+      cmDepends::GetInternalIndexFile(internalDependFile.c_str()).c_str());
     }
 }
 
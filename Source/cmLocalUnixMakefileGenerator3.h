@@ -208,6 +208,11 @@ public:
 
   /** Called from command-line hook to clear dependencies.  */
   virtual void ClearDependencies(cmMakefile* mf, bool verbose);
+
+  /** Get the file in which the dependency scans of one build share
+      file times, or an empty string if CMAKE_DEPENDS_STAT_CACHE is not
+      enabled.  */
+  std::string GetDependStatCacheFile();
   
   /** write some extra rules such as make test etc */
   void WriteSpecialTargetsTop(std::ostream& makefileStream);
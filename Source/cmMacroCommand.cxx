@@ -13,6 +13,210 @@
 
 #include "cmake.h"
 
+// Values substituted for references in a macro body during one call.
+// ARGN and ARGV are computed only if the body refers to them.
+class cmMacroCallValues
+{
+public:
+  cmMacroCallValues(std::vector<std::string> const& args,
+                    std::vector<std::string>::size_type numFormal):
+    Args(args), NumFormal(numFormal),
+    ARGNInitialized(false), ARGVInitialized(false)
+    {
+    cmOStringStream argcDefStream;
+    argcDefStream << args.size();
+    this->ARGC = argcDefStream.str();
+    }
+  std::string const& GetARGN()
+    {
+    if(!this->ARGNInitialized)
+      {
+      for(std::vector<std::string>::size_type i = this->NumFormal;
+          i < this->Args.size(); ++i)
+        {
+        if(!this->ARGN.empty())
+          {
+          this->ARGN += ";";
+          }
+        this->ARGN += this->Args[i];
+        }
+      this->ARGNInitialized = true;
+      }
+    return this->ARGN;
+    }
+  std::string const& GetARGV()
+    {
+    if(!this->ARGVInitialized)
+      {
+      for(std::vector<std::string>::const_iterator i = this->Args.begin();
+          i != this->Args.end(); ++i)
+        {
+        if(!this->ARGV.empty())
+          {
+          this->ARGV += ";";
+          }
+        this->ARGV += *i;
+        }
+      this->ARGVInitialized = true;
+      }
+    return this->ARGV;
+    }
+  std::vector<std::string> const& Args;
+  std::vector<std::string>::size_type NumFormal;
+  std::string ARGC;
+private:
+  std::string ARGN;
+  std::string ARGV;
+  bool ARGNInitialized;
+  bool ARGVInitialized;
+};
+
+// A macro body argument split at references to the macro arguments so
+// that a call can splice in the values with one pass.
+struct cmMacroArgumentTemplate
+{
+  enum SegmentType { Literal, Formal, ARGC, ARGN, ARGV, ARGVn };
+  struct Segment
+  {
+    SegmentType Type;
+    std::string Text;
+    unsigned int Index;
+  };
+  std::vector<Segment> Segments;
+
+  // Splicing matches the sequential replacement of each reference only
+  // if no substituted value can form a new reference with surrounding
+  // text.  That holds unless a reference is nested inside another
+  // "${...}" in the original text.
+  bool Simple;
+
+  void Compile(std::string const& text,
+               std::vector<std::string> const& formal);
+  void Splice(std::string& out, cmMacroCallValues& values) const;
+private:
+  void AddSegment(SegmentType type, std::string const& text,
+                  unsigned int index = 0);
+};
+
+//----------------------------------------------------------------------------
+void cmMacroArgumentTemplate::AddSegment(SegmentType type,
+                                         std::string const& text,
+                                         unsigned int index)
+{
+  Segment seg;
+  seg.Type = type;
+  seg.Text = text;
+  seg.Index = index;
+  this->Segments.push_back(seg);
+}
+
+//----------------------------------------------------------------------------
+void cmMacroArgumentTemplate::Compile(std::string const& text,
+                                      std::vector<std::string> const& formal)
+{
+  this->Segments.clear();
+  this->Simple = true;
+  std::string::size_type literal = 0;
+  std::string::size_type pos = 0;
+  std::string::size_type ref;
+  while((ref = text.find("${", pos)) != std::string::npos)
+    {
+    std::string::size_type close = text.find('}', ref+2);
+    if(close == std::string::npos)
+      {
+      break;
+      }
+    std::string name = text.substr(ref+2, close-ref-2);
+
+    // Classify the reference with the precedence of the replacements.
+    SegmentType type = Literal;
+    unsigned int index = 0;
+    for(unsigned int j = 1; j < formal.size(); ++j)
+      {
+      if(name == formal[j])
+        {
+        type = Formal;
+        index = j-1;
+        break;
+        }
+      }
+    if(type == Literal)
+      {
+      if(name == "ARGC")
+        {
+        type = ARGC;
+        }
+      else if(name == "ARGN")
+        {
+        type = ARGN;
+        }
+      else if(name == "ARGV")
+        {
+        type = ARGV;
+        }
+      else if(name.size() > 4 && name.compare(0, 4, "ARGV") == 0 &&
+              name.find_first_not_of("0123456789", 4) == std::string::npos &&
+              (name[4] != '0' || name.size() == 5) && name.size() < 14)
+        {
+        type = ARGVn;
+        index = static_cast<unsigned int>(atoi(name.c_str()+4));
+        }
+      }
+
+    if(type == Literal)
+      {
+      // Not a reference to a macro argument.  Look for one nested in it.
+      if(name.find("${") != std::string::npos)
+        {
+        this->Simple = false;
+        }
+      pos = ref+1;
+      }
+    else
+      {
+      if(ref > literal)
+        {
+        this->AddSegment(Literal, text.substr(literal, ref-literal));
+        }
+      this->AddSegment(type, text.substr(ref, close-ref+1), index);
+      literal = pos = close+1;
+      }
+    }
+  if(literal < text.size())
+    {
+    this->AddSegment(Literal, text.substr(literal));
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmMacroArgumentTemplate::Splice(std::string& out,
+                                     cmMacroCallValues& values) const
+{
+  out = "";
+  for(std::vector<Segment>::const_iterator i = this->Segments.begin();
+      i != this->Segments.end(); ++i)
+    {
+    switch(i->Type)
+      {
+      case Literal: out += i->Text; break;
+      case Formal: out += values.Args[i->Index]; break;
+      case ARGC: out += values.ARGC; break;
+      case ARGN: out += values.GetARGN(); break;
+      case ARGV: out += values.GetARGV(); break;
+      case ARGVn:
+        if(i->Index < values.Args.size())
+          {
+          out += values.Args[i->Index];
+          }
+        else
+          {
+          out += i->Text;
+          }
+        break;
+      }
+    }
+}
+
 // define the class for macro commands
 class cmMacroHelperCommand : public cmCommand
 {
@@ -31,6 +235,8 @@ public:
     // we must copy when we clone
     newC->Args = this->Args;
     newC->Functions = this->Functions;
+    newC->Templates = this->Templates;
+    newC->SimpleFormals = this->SimpleFormals;
     newC->Policies = this->Policies;
     return newC;
   }
@@ -73,14 +279,97 @@ public:
     return this->GetTerseDocumentation();
   }
 
+  /**
+   * Split the arguments of the body at references to macro arguments.
+   * Call once after setting Args and Functions.
+   */
+  void Compile();
+
   cmTypeMacro(cmMacroHelperCommand, cmCommand);
 
   std::vector<std::string> Args;
   std::vector<cmListFileFunction> Functions;
   cmPolicies::PolicyMap Policies;
+
+private:
+  void ReplaceArguments(std::string& tmps, cmMacroCallValues& values);
+
+  // Templates for the arguments of each function in the body.
+  std::vector<std::vector<cmMacroArgumentTemplate> > Templates;
+
+  // Whether the formal argument names allow splicing at all.
+  bool SimpleFormals;
 };
 
+//----------------------------------------------------------------------------
+void cmMacroHelperCommand::Compile()
+{
+  this->SimpleFormals = true;
+  for(unsigned int j = 1; j < this->Args.size(); ++j)
+    {
+    if(this->Args[j].find_first_of("${}") != std::string::npos)
+      {
+      this->SimpleFormals = false;
+      }
+    }
+
+  this->Templates.resize(this->Functions.size());
+  for(unsigned int c = 0; c < this->Functions.size(); ++c)
+    {
+    std::vector<cmListFileArgument> const& fargs =
+      this->Functions[c].Arguments;
+    this->Templates[c].resize(fargs.size());
+    for(unsigned int a = 0; a < fargs.size(); ++a)
+      {
+      this->Templates[c][a].Compile(fargs[a].Value, this->Args);
+      }
+    }
+}
 
+//----------------------------------------------------------------------------
+void cmMacroHelperCommand::ReplaceArguments(std::string& tmps,
+                                            cmMacroCallValues& values)
+{
+  std::string variable;
+
+  // replace formal arguments
+  for (unsigned int j = 1; j < this->Args.size(); ++j)
+    {
+    variable = "${";
+    variable += this->Args[j];
+    variable += "}"; 
+    cmSystemTools::ReplaceString(tmps, variable.c_str(),
+                                 values.Args[j-1].c_str());
+    }
+  // replace argc
+  cmSystemTools::ReplaceString(tmps, "${ARGC}",values.ARGC.c_str());
+
+  // repleace ARGN
+  if (tmps.find("${ARGN}") != std::string::npos)
+    {
+    cmSystemTools::ReplaceString(tmps, "${ARGN}", values.GetARGN().c_str());
+    }
+
+  // if the current argument of the current function has ${ARGV in it
+  // then try replacing ARGV values
+  if (tmps.find("${ARGV") != std::string::npos)
+    {
+    char argvName[60];
+
+    // repleace ARGV
+    cmSystemTools::ReplaceString(tmps, "${ARGV}", values.GetARGV().c_str());
+
+    // also replace the ARGV1 ARGV2 ... etc
+    for (unsigned int t = 0; t < values.Args.size(); ++t)
+      {
+      sprintf(argvName,"${ARGV%i}",t);
+      cmSystemTools::ReplaceString(tmps, argvName,
+                                   values.Args[t].c_str());
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
 bool cmMacroHelperCommand::InvokeInitialPass
 (const std::vector<cmListFileArgument>& args,
  cmExecutionStatus &inStatus)
@@ -89,9 +378,7 @@ bool cmMacroHelperCommand::InvokeInitialPass
   std::vector<std::string> expandedArgs;
   this->Makefile->ExpandArguments(args, expandedArgs);
 
-  std::string tmps;
   cmListFileArgument arg;
-  std::string variable;
 
   // make sure the number of arguments passed is at least the number
   // required by the signature
@@ -111,16 +398,19 @@ bool cmMacroHelperCommand::InvokeInitialPass
   // macro creation.
   cmMakefile::PolicyPushPop polScope(this->Makefile, true, this->Policies);
 
-  // set the value of argc
-  cmOStringStream argcDefStream;
-  argcDefStream << expandedArgs.size();
-  std::string argcDef = argcDefStream.str();
+  cmMacroCallValues values(expandedArgs, this->Args.size() - 1);
 
-  // declare varuiables for ARGV ARGN but do not compute until needed
-  std::string argvDef;
-  std::string argnDef;
-  bool argnDefInitialized = false;
-  bool argvDefInitialized = false;
+  // The compiled templates may be spliced only if no value contains
+  // characters that could form a new reference.
+  bool splice = this->SimpleFormals;
+  for(std::vector<std::string>::const_iterator i = expandedArgs.begin();
+      splice && i != expandedArgs.end(); ++i)
+    {
+    if(i->find_first_of("${}") != std::string::npos)
+      {
+      splice = false;
+      }
+    }
 
   // Invoke all the functions that were collected in the block.
   cmListFileFunction newLFF;
@@ -133,84 +423,27 @@ bool cmMacroHelperCommand::InvokeInitialPass
     newLFF.Name = this->Functions[c].Name;
     newLFF.FilePath = this->Functions[c].FilePath;
     newLFF.Line = this->Functions[c].Line;
+    newLFF.Command = this->Functions[c].Command;
+    newLFF.CommandGeneration = this->Functions[c].CommandGeneration;
 
     // for each argument of the current function
-    for (std::vector<cmListFileArgument>::const_iterator k = 
-           this->Functions[c].Arguments.begin();
-         k != this->Functions[c].Arguments.end(); ++k)
+    std::vector<cmMacroArgumentTemplate> const& templates =
+      this->Templates[c];
+    for (unsigned int a = 0; a < templates.size(); ++a)
       {
-      tmps = k->Value;
-      // replace formal arguments
-      for (unsigned int j = 1; j < this->Args.size(); ++j)
+      cmListFileArgument const& k = this->Functions[c].Arguments[a];
+      if(splice && templates[a].Simple)
         {
-        variable = "${";
-        variable += this->Args[j];
-        variable += "}"; 
-        cmSystemTools::ReplaceString(tmps, variable.c_str(),
-                                     expandedArgs[j-1].c_str());
+        templates[a].Splice(arg.Value, values);
         }
-      // replace argc
-      cmSystemTools::ReplaceString(tmps, "${ARGC}",argcDef.c_str());
-
-      // repleace ARGN
-      if (tmps.find("${ARGN}") != std::string::npos)
+      else
         {
-        if (!argnDefInitialized)
-          {
-          std::vector<std::string>::const_iterator eit;
-          std::vector<std::string>::size_type cnt = 0;
-          for ( eit = expandedArgs.begin(); eit != expandedArgs.end(); ++eit )
-            {
-            if ( cnt >= this->Args.size()-1 )
-              {
-              if ( argnDef.size() > 0 )
-                {
-                argnDef += ";";
-                }
-              argnDef += *eit;
-              }
-            cnt ++;
-            }
-          argnDefInitialized = true;
-          }
-        cmSystemTools::ReplaceString(tmps, "${ARGN}", argnDef.c_str());
+        arg.Value = k.Value;
+        this->ReplaceArguments(arg.Value, values);
         }
-
-      // if the current argument of the current function has ${ARGV in it
-      // then try replacing ARGV values
-      if (tmps.find("${ARGV") != std::string::npos)
-        {
-        char argvName[60];
-
-        // repleace ARGV, compute it only once
-        if (!argvDefInitialized)
-          {
-          std::vector<std::string>::const_iterator eit;
-          for ( eit = expandedArgs.begin(); eit != expandedArgs.end(); ++eit )
-            {
-            if ( argvDef.size() > 0 )
-              {
-              argvDef += ";";
-              }
-            argvDef += *eit;
-            }
-          argvDefInitialized = true;
-          }
-        cmSystemTools::ReplaceString(tmps, "${ARGV}", argvDef.c_str());
-
-        // also replace the ARGV1 ARGV2 ... etc
-        for (unsigned int t = 0; t < expandedArgs.size(); ++t)
-          {
-          sprintf(argvName,"${ARGV%i}",t);
-          cmSystemTools::ReplaceString(tmps, argvName,
-                                       expandedArgs[t].c_str());
-          }
-        }
-
-      arg.Value = tmps;
-      arg.Quoted = k->Quoted;
-      arg.FilePath = k->FilePath;
-      arg.Line = k->Line;
+      arg.Quoted = k.Quoted;
+      arg.FilePath = k.FilePath;
+      arg.Line = k.Line;
       newLFF.Arguments.push_back(arg);
       }
     cmExecutionStatus status;
@@ -266,6 +499,7 @@ IsFunctionBlocked(const cmListFileFunction& lff, cmMakefile &mf,
       cmMacroHelperCommand *f = new cmMacroHelperCommand();
       f->Args = this->Args;
       f->Functions = this->Functions;
+      f->Compile();
       mf.RecordPolicies(f->Policies);
       std::string newName = "_" + this->Args[0];
       mf.GetCMakeInstance()->RenameCommand(this->Args[0].c_str(), 
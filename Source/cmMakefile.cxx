@@ -21,6 +21,7 @@
 #include "cmCacheManager.h"
 #include "cmFunctionBlocker.h"
 #include "cmListFileCache.h"
+#include "cmCommandArgumentExpander.h"
 #include "cmCommandArgumentParserHelper.h"
 #include "cmTest.h"
 #ifdef CMAKE_BUILD_WITH_CMAKE
@@ -350,6 +351,23 @@ bool cmMakefile::GetBacktrace(cmListFileBacktrace& backtrace) const
   return true;
 }
 
+//----------------------------------------------------------------------------
+// Mark a command instance as in use for the duration of one call.
+class cmMakefileInvoking
+{
+public:
+  cmMakefileInvoking(cmCommand* cmd): Command(cmd)
+    {
+    this->Command->SetInvoking(true);
+    }
+  ~cmMakefileInvoking()
+    {
+    this->Command->SetInvoking(false);
+    }
+private:
+  cmCommand* Command;
+};
+
 //----------------------------------------------------------------------------
 bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
                                 cmExecutionStatus &status)
@@ -363,17 +381,27 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
     return result;
     }
   
-  std::string name = lff.Name;
-
   // Place this call on the call stack.
   cmMakefileCall stack_manager(this, lff, status);
   static_cast<void>(stack_manager);
 
   // Lookup the command prototype.
-  if(cmCommand* proto = this->GetCMakeInstance()->GetCommand(name.c_str()))
+  if(cmCommand* proto = this->GetCMakeInstance()->ResolveCommand(lff))
     {
-    // Clone the prototype.
-    cmsys::auto_ptr<cmCommand> pcmd(proto->Clone());
+    // Invoke a stateless command on its prototype unless that is
+    // already in use further up the stack.  Otherwise use a clone.
+    cmsys::auto_ptr<cmCommand> clone;
+    cmCommand* pcmd = proto;
+    if(proto->IsStateless() && !proto->GetInvoking())
+      {
+      proto->ClearError();
+      }
+    else
+      {
+      clone.reset(proto->Clone());
+      pcmd = clone.get();
+      }
+    cmMakefileInvoking invoking(pcmd);
     pcmd->SetMakefile(this);
 
     // Decide whether to invoke the command.
@@ -410,10 +438,10 @@ bool cmMakefile::ExecuteCommand(const cmListFileFunction& lff,
           cmSystemTools::SetFatalErrorOccured();
           }
         }
-      else if(pcmd->HasFinalPass())
+      else if(clone.get() && pcmd->HasFinalPass())
         {
         // use the command
-        this->UsedCommands.push_back(pcmd.release());
+        this->UsedCommands.push_back(clone.release());
         }
       }
     else if ( this->GetCMakeInstance()->GetScriptMode()
@@ -641,8 +669,24 @@ bool cmMakefile::ReadListFile(const char* filename_in,
     {
     *fullPath=filenametoread;
     }
-  cmListFile cacheFile;
-  if( !cacheFile.ParseFile(filenametoread, requireProjectCommand, this) )
+  // The top-level file may be modified by the parser to add a project
+  // command so it is not shared.  All others come from the cache of
+  // parsed files.
+  cmListFile topFile;
+  cmListFile const* cacheFile = &topFile;
+  if(requireProjectCommand)
+    {
+    if(!topFile.ParseFile(filenametoread, requireProjectCommand, this))
+      {
+      cacheFile = 0;
+      }
+    }
+  else
+    {
+    cacheFile = this->GetCMakeInstance()->GetListFileCache()
+      ->GetFile(filenametoread, this);
+    }
+  if(!cacheFile)
     {
     // pop the listfile off the stack
     this->ListFileStack.pop_back();
@@ -663,11 +707,11 @@ bool cmMakefile::ReadListFile(const char* filename_in,
   IncludeScope incScope(this, filenametoread, noPolicyScope);
 
   // Run the parsed commands.
-  const size_t numberFunctions = cacheFile.Functions.size();
+  const size_t numberFunctions = cacheFile->Functions.size();
   for(size_t i =0; i < numberFunctions; ++i)
     {
     cmExecutionStatus status;
-    this->ExecuteCommand(cacheFile.Functions[i],status);
+    this->ExecuteCommand(cacheFile->Functions[i],status);
     if(cmSystemTools::GetFatalErrorOccured())
       {
       // Exit early due to error.
@@ -2233,6 +2277,21 @@ const char *cmMakefile::ExpandVariablesInString(std::string& source,
   // It also supports the $ENV{VAR} syntax where VAR is looked up in
   // the current environment variables.
 
+  // Most arguments use only plain references and escapes.  Expand them
+  // directly and leave other syntax and error reporting to the parser.
+  cmCommandArgumentExpander expander(this);
+  expander.SetLineFile(line);
+  expander.SetEscapeQuotes(escapeQuotes);
+  expander.SetNoEscapeMode(noEscapes);
+  expander.SetReplaceAtSyntax(replaceAt);
+  expander.SetRemoveEmpty(removeEmpty);
+  std::string expanded;
+  if(expander.Expand(source, expanded))
+    {
+    source.swap(expanded);
+    return source.c_str();
+    }
+
   cmCommandArgumentParserHelper parser;
   parser.SetMakefile(this);
   parser.SetLineFile(line, filename);
@@ -3382,8 +3441,9 @@ void cmMakefile::RaiseScope(const char *var, const char *varDef)
   cmDefinitions& cur = this->Internal->VarStack.top();
   if(cmDefinitions* up = cur.GetParent())
     {
-    // First localize the definition in the current scope.
-    cur.Get(var);
+    // First localize the definition in the current scope.  It may
+    // only be a reference to the value about to change.
+    cur.Set(var, cur.Get(var));
 
     // Now update the definition in the parent scope.
     up->Set(var, varDef);
@@ -984,6 +984,17 @@ void cmMakefileTargetGenerator::WriteTargetDependRules()
       << "SET(CMAKE_Fortran_TARGET_MODULE_DIR \"" << mdir << "\")\n";
     }
 
+  // Check for a file time snapshot shared by dependency scans.
+  std::string statCache = this->LocalGenerator->GetDependStatCacheFile();
+  if(!statCache.empty())
+    {
+    *this->InfoFileStream
+      << "\n"
+      << "# File times shared by the dependency scans of one build.\n"
+      << "SET(CMAKE_DEPENDS_STAT_CACHE_FILE "
+      << this->LocalGenerator->EscapeForCMake(statCache.c_str()) << ")\n";
+    }
+
   // and now write the rule to use it
   std::vector<std::string> depends;
   std::vector<std::string> commands;
@@ -1046,6 +1057,13 @@ void cmMakefileTargetGenerator::WriteTargetDependRules()
     this->DriveCustomCommands(depends);
     }
 
+  // Without prerequisites the scan does not need make to evaluate
+  // build.make, so the all rules may run it directly.
+  if(depends.empty())
+    {
+    this->DependCommand = depCmd.str();
+    }
+
   // Write the rule.
   this->LocalGenerator->WriteMakeRule(*this->BuildFileStream, 0,
                                       depTarget.c_str(),
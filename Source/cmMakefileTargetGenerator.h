@@ -48,6 +48,10 @@ public:
   std::string GetProgressFileNameFull()
     { return this->ProgressFileNameFull; }
 
+  /* return the dependency scanning command if it may be run without
+     going through the target's build.make, or an empty string */
+  std::string const& GetDependCommand() { return this->DependCommand; }
+
   cmTarget* GetTarget() { return this->Target;}
 protected:
 
@@ -164,6 +168,10 @@ protected:
   unsigned long NumberOfProgressActions;
   bool NoRuleMessages;
 
+  // the dependency scanning command when the depend rule has no
+  // prerequisites
+  std::string DependCommand;
+
   // the path to the directory the build file is in
   std::string TargetBuildDirectory;
   std::string TargetBuildDirectoryFull;
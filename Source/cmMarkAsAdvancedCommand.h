@@ -77,6 +77,11 @@ public:
   */
   virtual bool IsScriptable() { return true; }
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() { return true; }
+
   cmTypeMacro(cmMarkAsAdvancedCommand, cmCommand);
 };
 
@@ -67,6 +67,11 @@ public:
    */
   virtual bool IsScriptable() { return true; }
 
+  /**
+   * This command keeps no state between invocations.
+   */
+  virtual bool IsStateless() { return true; }
+
   cmTypeMacro(cmOptionCommand, cmCommand);
 };
 
@@ -68,7 +68,6 @@ void cmVariableWatchCommand::VariableAccessed(const std::string& variable,
     }
   this->InCallback = true;
 
-  cmListFileFunction newLFF;
   cmVariableWatchCommandHandler *handler = &this->Handlers[variable];
   cmVariableWatchCommandHandler::VectorOfCommands::iterator it;
   cmListFileArgument arg;
@@ -84,7 +83,7 @@ void cmVariableWatchCommand::VariableAccessed(const std::string& variable,
     ++ it )
     {
     std::string command = *it;
-    newLFF.Arguments.clear();
+    cmListFileFunction newLFF;
     newLFF.Arguments.push_back(
       cmListFileArgument(variable, true, "unknown", 9999));
     newLFF.Arguments.push_back(
@@ -19,6 +19,7 @@
 #include "cmCommands.h"
 #include "cmCommand.h"
 #include "cmFileTimeComparison.h"
+#include "cmListFileCache.h"
 #include "cmGeneratedFileStream.h"
 #include "cmSourceFile.h"
 #include "cmVersion.h"
@@ -139,13 +140,16 @@ void cmNeedBackwardsCompatibility(const std::string& variable,
 
 cmake::cmake()
 {
+  this->CommandGeneration = 0;
   this->Trace = false;
+  this->TraceStats = false;
   this->SuppressDevWarnings = false;
   this->DoSuppressDevWarnings = false;
   this->DebugOutput = false;
   this->DebugTryCompile = false;
   this->ClearBuildSystem = false;
   this->FileComparison = new cmFileTimeComparison;
+  this->ListFileCache = new cmListFileCache;
 
   this->Policies = new cmPolicies();
   this->InitializeProperties();
@@ -216,6 +220,7 @@ cmake::~cmake()
   delete this->VariableWatch;
 #endif
   delete this->FileComparison;
+  delete this->ListFileCache;
 }
 
 void cmake::InitializeProperties()
@@ -258,6 +263,7 @@ void cmake::CleanupCommandsAndMacros()
     {
     this->Commands[cmSystemTools::LowerCase((*it)->GetName())] = *it;
     }
+  this->CommandsChanged();
 }
 
 bool cmake::CommandExists(const char* name) const
@@ -278,6 +284,35 @@ cmCommand *cmake::GetCommand(const char *name)
   return rm;
 }
 
+cmCommand *cmake::ResolveCommand(cmListFileFunction const& lff)
+{
+  if(lff.CommandGeneration != this->CommandGeneration)
+    {
+    // Calls copied into macro and function bodies are resolved again,
+    // so remember each spelling of a name to avoid lower-casing it.
+    RegisteredCommandsMap::iterator i = this->CommandSpellings.find(lff.Name);
+    if(i == this->CommandSpellings.end())
+      {
+      i = this->CommandSpellings.insert(
+        RegisteredCommandsMap::value_type(
+          lff.Name, this->GetCommand(lff.Name.c_str()))).first;
+      }
+    lff.Command = i->second;
+    lff.CommandGeneration = this->CommandGeneration;
+    }
+  return lff.Command;
+}
+
+void cmake::CommandsChanged()
+{
+  // Take a generation number unique across all cmake instances in the
+  // process so a call resolved by one instance is never trusted by
+  // another.
+  static unsigned long nextGeneration = 0;
+  this->CommandGeneration = ++nextGeneration;
+  this->CommandSpellings.clear();
+}
+
 void cmake::RenameCommand(const char*oldName, const char* newName)
 {
   // if the command already exists, free the old one
@@ -299,6 +334,7 @@ void cmake::RenameCommand(const char*oldName, const char* newName)
   this->Commands.insert(RegisteredCommandsMap::value_type(sNewName, cmd));
   pos = this->Commands.find(sOldName);
   this->Commands.erase(pos);
+  this->CommandsChanged();
 }
 
 void cmake::RemoveCommand(const char* name)
@@ -309,6 +345,7 @@ void cmake::RemoveCommand(const char* name)
     {
     delete pos->second;
     this->Commands.erase(pos);
+    this->CommandsChanged();
     }
 }
 
@@ -323,6 +360,7 @@ void cmake::AddCommand(cmCommand* wg)
     this->Commands.erase(pos);
     }
   this->Commands.insert( RegisteredCommandsMap::value_type(name, wg));
+  this->CommandsChanged();
 }
 
 
@@ -618,6 +656,10 @@ void cmake::SetArgs(const std::vector<std::string>& args)
       std::cout << "Running with debug output on.\n";
       this->SetDebugOutputOn(true);
       }
+    else if(arg.find("--trace-stats",0) == 0)
+      {
+      this->SetTraceStats(true);
+      }
     else if(arg.find("--trace",0) == 0)
       {
       std::cout << "Running with trace output on.\n";
@@ -1267,7 +1309,8 @@ int cmake::ExecuteCMakeCommand(std::vector<std::string>& args)
       }
 
     // Command to start progress for a build
-    else if (args[1] == "cmake_progress_start" && args.size() == 4)
+    else if (args[1] == "cmake_progress_start" &&
+             (args.size() == 4 || args.size() == 5))
       {
       // bascially remove the directory
       std::string dirName = args[2];
@@ -1275,19 +1318,34 @@ int cmake::ExecuteCMakeCommand(std::vector<std::string>& args)
       cmSystemTools::RemoveADirectory(dirName.c_str());
 
       // is the last argument a filename that exists?
+      // it may be followed by the number of the last mark in the tree
       FILE *countFile = fopen(args[3].c_str(),"r");
       int count;
+      int last = 0;
       if (countFile)
         {
         if (1!=fscanf(countFile,"%i",&count))
           {
           cmSystemTools::Message("Could not read from count file.");
           }
+        else if (1!=fscanf(countFile,"%i",&last))
+          {
+          last = 0;
+          }
         fclose(countFile);
         }
       else
         {
         count = atoi(args[3].c_str());
+        if (args.size() == 5)
+          {
+          last = atoi(args[4].c_str());
+          }
+        }
+      // marks are numbered from one, at least up to the count
+      if (last < count)
+        {
+        last = count;
         }
       if (count)
         {
@@ -1298,7 +1356,18 @@ int cmake::ExecuteCMakeCommand(std::vector<std::string>& args)
         FILE *progFile = fopen(fName.c_str(),"w");
         if (progFile)
           {
-          fprintf(progFile,"%i\n",count);
+          fprintf(progFile,"%i\n%i\n",count,last);
+          fclose(progFile);
+          }
+
+        // create the file of reported marks with a byte for each mark
+        fName = dirName;
+        fName += "/marks.bin";
+        progFile = fopen(fName.c_str(),"wb");
+        if (progFile)
+          {
+          std::vector<char> marks(last + 1, 0);
+          fwrite(&marks[0], 1, marks.size(), progFile);
           fclose(progFile);
           }
         }
@@ -1318,6 +1387,7 @@ int cmake::ExecuteCMakeCommand(std::vector<std::string>& args)
       fName += "/count.txt";
       progFile = fopen(fName.c_str(),"r");
       int count = 0;
+      int last = 0;
       if (!progFile)
         {
         return 0;
@@ -1328,27 +1398,54 @@ int cmake::ExecuteCMakeCommand(std::vector<std::string>& args)
           {
           cmSystemTools::Message("Could not read from progress file.");
           }
+        else if (1!=fscanf(progFile,"%i",&last))
+          {
+          last = count;
+          }
         fclose(progFile);
         }
-      unsigned int i;
-      for (i = 3; i < args.size(); ++i)
+      // Each mark up to the last one owns one byte of the marks file.
+      // Setting a byte is safe while other reports run and reporting a
+      // mark twice has no effect, as with the one file per mark used
+      // before.
+      fName = dirName;
+      fName += "/marks.bin";
+      progFile = fopen(fName.c_str(),"r+b");
+      if (!progFile)
         {
-        fName = dirName;
-        fName += "/";
-        fName += args[i];
-        progFile = fopen(fName.c_str(),"w");
-        if (progFile)
+        return 0;
+        }
+      for (unsigned int i = 3; i < args.size(); ++i)
+        {
+        char* end;
+        long mark = strtol(args[i].c_str(), &end, 10);
+        if (end != args[i].c_str() && *end == 0 &&
+            mark >= 0 && mark <= last &&
+            fseek(progFile, mark, SEEK_SET) == 0)
           {
-          fprintf(progFile,"empty");
-          fclose(progFile);
+          fputc(1, progFile);
           }
         }
-      int fileNum = static_cast<int>
-        (cmsys::Directory::GetNumberOfFilesInDirectory(dirName.c_str()));
+
+      // Count the marks reported so far.
+      int marks = 0;
+      if (fflush(progFile) == 0 && fseek(progFile, 0, SEEK_SET) == 0)
+        {
+        char buffer[4096];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), progFile)) > 0)
+          {
+          for (size_t j = 0; j < n; ++j)
+            {
+            marks += buffer[j]? 1 : 0;
+            }
+          }
+        }
+      fclose(progFile);
       if (count > 0)
         {
         // print the progress
-        fprintf(stdout,"[%3i%%] ",((fileNum-3)*100)/count);
+        fprintf(stdout,"[%3i%%] ",(marks*100)/count);
         }
       return 0;
       }
@@ -2295,7 +2392,15 @@ int cmake::Generate()
     {
     return -1;
     }
+
+  // Compare generated files with the hashes recorded by the last run
+  // instead of reading them back.
+  std::string hashes = this->GetHomeOutputDirectory();
+  hashes += cmake::GetCMakeFilesDirectory();
+  hashes += "/CMakeGeneratedFiles.md5";
+  cmGeneratedFileStream::LoadContentHashes(hashes.c_str());
   this->GlobalGenerator->Generate();
+  cmGeneratedFileStream::SaveContentHashes();
   if(cmSystemTools::GetErrorOccuredFlag())
     {
     return -1;
@@ -2554,6 +2659,17 @@ int cmake::CheckBuildSystem()
     return 1;
     }
 
+  // The generator also writes the lists read below to a manifest.
+  // Use it when possible so that no interpreter is needed.
+  std::vector<std::string> products;
+  std::vector<std::string> depends;
+  std::vector<std::string> outputs;
+  if(!this->ClearBuildSystem &&
+     this->ReadBuildSystemManifest(products, depends, outputs))
+    {
+    return this->CheckBuildSystemFiles(products, depends, outputs, verbose);
+    }
+
   // Read the rerun check file and use it to decide whether to do the
   // global generate.
   cmake cm;
@@ -2594,12 +2710,28 @@ int cmake::CheckBuildSystem()
       }
     }
 
-  // If any byproduct of makefile generation is missing we must re-run.
-  std::vector<std::string> products;
+  // Get the set of byproducts, dependencies and outputs.
   if(const char* productStr = mf->GetDefinition("CMAKE_MAKEFILE_PRODUCTS"))
     {
     cmSystemTools::ExpandListArgument(productStr, products);
     }
+  const char* dependsStr = mf->GetDefinition("CMAKE_MAKEFILE_DEPENDS");
+  const char* outputsStr = mf->GetDefinition("CMAKE_MAKEFILE_OUTPUTS");
+  if(dependsStr && outputsStr)
+    {
+    cmSystemTools::ExpandListArgument(dependsStr, depends);
+    cmSystemTools::ExpandListArgument(outputsStr, outputs);
+    }
+  return this->CheckBuildSystemFiles(products, depends, outputs, verbose);
+}
+
+//----------------------------------------------------------------------------
+int cmake::CheckBuildSystemFiles(std::vector<std::string> const& products,
+                                 std::vector<std::string> const& depends,
+                                 std::vector<std::string> const& outputs,
+                                 bool verbose)
+{
+  // If any byproduct of makefile generation is missing we must re-run.
   for(std::vector<std::string>::const_iterator pi = products.begin();
       pi != products.end(); ++pi)
     {
@@ -2616,16 +2748,6 @@ int cmake::CheckBuildSystem()
       }
     }
 
-  // Get the set of dependencies and outputs.
-  std::vector<std::string> depends;
-  std::vector<std::string> outputs;
-  const char* dependsStr = mf->GetDefinition("CMAKE_MAKEFILE_DEPENDS");
-  const char* outputsStr = mf->GetDefinition("CMAKE_MAKEFILE_OUTPUTS");
-  if(dependsStr && outputsStr)
-    {
-    cmSystemTools::ExpandListArgument(dependsStr, depends);
-    cmSystemTools::ExpandListArgument(outputsStr, outputs);
-    }
   if(depends.empty() || outputs.empty())
     {
     // Not enough information was provided to do the test.  Just rerun.
@@ -2640,7 +2762,7 @@ int cmake::CheckBuildSystem()
     }
 
   // Find find the newest dependency.
-  std::vector<std::string>::iterator dep = depends.begin();
+  std::vector<std::string>::const_iterator dep = depends.begin();
   std::string dep_newest = *dep++;
   for(;dep != depends.end(); ++dep)
     {
@@ -2666,7 +2788,7 @@ int cmake::CheckBuildSystem()
     }
 
   // Find find the oldest output.
-  std::vector<std::string>::iterator out = outputs.begin();
+  std::vector<std::string>::const_iterator out = outputs.begin();
   std::string out_oldest = *out++;
   for(;out != outputs.end(); ++out)
     {
@@ -2714,6 +2836,121 @@ int cmake::CheckBuildSystem()
   return 0;
 }
 
+// The build system manifest is a header of 32-bit words in host byte
+// order followed by the NUL-terminated byproducts, dependencies and
+// outputs.  It records the size and time of the check file it mirrors.
+enum
+{
+  cmakeManifestMagic = 0x434d4253,
+  cmakeManifestVersion = 1,
+  cmakeManifestHeaderWords = 7
+};
+
+//----------------------------------------------------------------------------
+std::string cmake::GetBuildSystemManifest(const char* checkFile)
+{
+  std::string manifest = checkFile;
+  manifest += ".bin";
+  return manifest;
+}
+
+//----------------------------------------------------------------------------
+void cmake::WriteBuildSystemManifest(
+  const char* checkFile, std::vector<std::string> const& products,
+  std::vector<std::string> const& depends,
+  std::vector<std::string> const& outputs)
+{
+  std::string manifest = cmake::GetBuildSystemManifest(checkFile);
+  unsigned int header[cmakeManifestHeaderWords];
+  header[0] = cmakeManifestMagic;
+  header[1] = cmakeManifestVersion;
+  header[2] = static_cast<unsigned int>(cmSystemTools::FileLength(checkFile));
+  header[3] =
+    static_cast<unsigned int>(cmSystemTools::ModifiedTime(checkFile));
+  header[4] = static_cast<unsigned int>(products.size());
+  header[5] = static_cast<unsigned int>(depends.size());
+  header[6] = static_cast<unsigned int>(outputs.size());
+  std::string strings;
+  std::vector<std::string> const* lists[3] = {&products, &depends, &outputs};
+  for(int l = 0; l < 3; ++l)
+    {
+    for(std::vector<std::string>::const_iterator i = lists[l]->begin();
+        i != lists[l]->end(); ++i)
+      {
+      strings += *i;
+      strings += '\0';
+      }
+    }
+
+  cmGeneratedFileStream fout;
+  fout.Open(manifest.c_str(), true, true);
+  fout.write(reinterpret_cast<const char*>(header), sizeof(header));
+  fout.write(strings.data(), strings.size());
+  if(!fout.Close())
+    {
+    cmSystemTools::RemoveFile(manifest.c_str());
+    }
+}
+
+//----------------------------------------------------------------------------
+bool cmake::ReadBuildSystemManifest(std::vector<std::string>& products,
+                                    std::vector<std::string>& depends,
+                                    std::vector<std::string>& outputs)
+{
+  const char* checkFile = this->CheckBuildSystemArgument.c_str();
+  std::string manifest = cmake::GetBuildSystemManifest(checkFile);
+  unsigned long length = cmSystemTools::FileLength(manifest.c_str());
+  if(length < sizeof(unsigned int) * cmakeManifestHeaderWords)
+    {
+    return false;
+    }
+
+  // Read the whole manifest with one call.
+  std::vector<unsigned int> data((length + 3) / 4);
+#if defined(_WIN32) || defined(__CYGWIN__)
+  std::ifstream fin(manifest.c_str(), std::ios::in | std::ios::binary);
+#else
+  std::ifstream fin(manifest.c_str(), std::ios::in);
+#endif
+  if(!fin || !fin.read(reinterpret_cast<char*>(&data[0]),
+                       static_cast<std::streamsize>(length)))
+    {
+    return false;
+    }
+
+  // The manifest must describe the current check file.
+  const unsigned int* header = &data[0];
+  if(header[0] != cmakeManifestMagic || header[1] != cmakeManifestVersion ||
+     header[2] !=
+     static_cast<unsigned int>(cmSystemTools::FileLength(checkFile)) ||
+     header[3] !=
+     static_cast<unsigned int>(cmSystemTools::ModifiedTime(checkFile)))
+    {
+    return false;
+    }
+
+  // Split the strings into the three lists.
+  const char* s = reinterpret_cast<const char*>(header +
+                                                cmakeManifestHeaderWords);
+  const char* end = reinterpret_cast<const char*>(&data[0]) + length;
+  std::vector<std::string>* lists[3] = {&products, &depends, &outputs};
+  for(int l = 0; l < 3; ++l)
+    {
+    lists[l]->clear();
+    for(unsigned int n = header[4+l]; n > 0; --n)
+      {
+      const char* e = static_cast<const char*>(memchr(s, 0, end-s));
+      if(!e)
+        {
+        return false;
+        }
+      lists[l]->push_back(std::string(s, e));
+      s = e+1;
+      }
+    }
+  return s == end;
+}
+
 //----------------------------------------------------------------------------
 void cmake::TruncateOutputLog(const char* fname)
 {
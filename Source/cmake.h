@@ -46,10 +46,12 @@ class cmMakefile;
 class cmCommand;
 class cmVariableWatch;
 class cmFileTimeComparison;
+class cmListFileCache;
 class cmExternalMakefileProjectGenerator;
 class cmDocumentationSection;
 class cmPolicies;
 class cmListFileBacktrace;
+struct cmListFileFunction;
 
 class cmake
 {
@@ -187,6 +189,18 @@ class cmake
    */
   static int ExecuteCMakeCommand(std::vector<std::string>&);
 
+  /**
+   * Write the manifest read by --check-build-system in place of the
+   * given check file, which must already be complete.  It lists the
+   * same byproducts, dependencies and outputs so the check needs no
+   * interpreter.
+   */
+  static void WriteBuildSystemManifest(
+    const char* checkFile, std::vector<std::string> const& products,
+    std::vector<std::string> const& depends,
+    std::vector<std::string> const& outputs);
+  static std::string GetBuildSystemManifest(const char* checkFile);
+
   /** 
    * Get the system information and write it to the file specified
    */
@@ -205,6 +219,12 @@ class cmake
    */
   cmCommand *GetCommand(const char *name);
 
+  /**
+   * Get the command invoked by a function call.  The lookup result is
+   * stored in the call and reused until the set of commands changes.
+   */
+  cmCommand *ResolveCommand(cmListFileFunction const& lff);
+
   /** Get list of all commands */
   RegisteredCommandsMap* GetCommands() { return &this->Commands; }
 
@@ -293,6 +313,11 @@ class cmake
    */
   cmFileTimeComparison* GetFileComparison() { return this->FileComparison; }
 
+  /**
+   * Get the cache of parsed list files shared by all directories.
+   */
+  cmListFileCache* GetListFileCache() { return this->ListFileCache; }
+
   /**
    * Get the path to ctest
    */
@@ -306,6 +331,10 @@ class cmake
   // Do we want trace output during the cmake run.
   bool GetTrace() { return this->Trace;}
   void SetTrace(bool b) {  this->Trace = b;}
+
+  // Do we want internal cache statistics at the end of the run.
+  bool GetTraceStats() { return this->TraceStats;}
+  void SetTraceStats(bool b) {  this->TraceStats = b;}
   // Define a property
   void DefineProperty(const char *name, cmProperty::ScopeType scope,
                       const char *ShortDescription,
@@ -369,6 +398,9 @@ protected:
   typedef std::map<cmStdString,
                    CreateGeneratorFunctionType> RegisteredGeneratorsMap;
   RegisteredCommandsMap Commands;
+  RegisteredCommandsMap CommandSpellings;
+  unsigned long CommandGeneration;
+  void CommandsChanged();
   RegisteredGeneratorsMap Generators;
   RegisteredExtraGeneratorsMap ExtraGenerators;
   void AddDefaultCommands();
@@ -400,6 +432,19 @@ protected:
    */
   int CheckBuildSystem();
 
+  // Read the manifest written by WriteBuildSystemManifest.  Returns
+  // false if it is missing or does not match the check file.
+  bool ReadBuildSystemManifest(std::vector<std::string>& products,
+                               std::vector<std::string>& depends,
+                               std::vector<std::string>& outputs);
+
+  // Compare the byproducts, dependencies and outputs of the build
+  // system.  Returns 1 if CMake should rerun and 0 otherwise.
+  int CheckBuildSystemFiles(std::vector<std::string> const& products,
+                            std::vector<std::string> const& depends,
+                            std::vector<std::string> const& outputs,
+                            bool verbose);
+
   void SetDirectoriesFromFile(const char* arg);
 
   //! Make sure all commands are what they say they are and there is no
@@ -443,6 +488,7 @@ private:
   bool ScriptMode;
   bool DebugOutput;
   bool Trace;
+  bool TraceStats;
   std::string CMakeEditCommand;
   std::string CMakeCommand;
   std::string CXXEnvironment;
@@ -456,6 +502,7 @@ private:
   bool ClearBuildSystem;
   bool DebugTryCompile;
   cmFileTimeComparison* FileComparison;
+  cmListFileCache* ListFileCache;
   std::string GraphVizFile;
   std::vector<std::string> DebugConfigs;
   
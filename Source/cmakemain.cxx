@@ -120,6 +120,9 @@ static const char * cmDocumentationOptions[][3] =
   {"--trace", "Put cmake in trace mode.",
    "Print a trace of all calls made and from where with "
    "message(send_error ) calls."},
+  {"--trace-stats", "Print internal cache statistics.",
+   "Print hit and miss counts of the caches cmake uses while generating "
+   "the build system.  This is useful when profiling large projects."},
   {"--help-command cmd [file]", "Print help for a single command and exit.",
    "Full documentation specific to the given command is displayed. "
    "If a file is specified, the documentation is written into and the output "
@@ -240,6 +243,7 @@ static const char * cmDocumentationNOTE[][3] =
 
 int do_cmake(int ac, char** av);
 static int do_build(int ac, char** av);
+static int do_command(int ac, char** av);
 
 static cmMakefile* cmakemainGetMakefile(void *clientdata)
 {
@@ -315,6 +319,10 @@ int main(int ac, char** av)
     {
     return do_build(ac, av);
     }
+  if(ac > 1 && strcmp(av[1], "-E") == 0)
+    {
+    return do_command(ac, av);
+    }
   int ret = do_cmake(ac, av);
 #ifdef CMAKE_BUILD_WITH_CMAKE
   cmDynamicLoader::FlushCache();
@@ -542,6 +550,29 @@ int do_cmake(int ac, char** av)
     }
 }
 
+//----------------------------------------------------------------------------
+static int do_command(int ac, char** av)
+{
+  // Generated build systems run "cmake -E" many times per build.  Go
+  // straight to the command without setting up the documentation or
+  // parsing the other options.
+  if(cmSystemTools::GetCurrentWorkingDirectory().empty())
+    {
+    return do_cmake(ac, av);
+    }
+  std::vector<std::string> args;
+  args.push_back(av[0]);
+  for(int i = 2; i < ac; ++i)
+    {
+    args.push_back(av[i]);
+    }
+  int ret = cmake::ExecuteCMakeCommand(args);
+#ifdef CMAKE_BUILD_WITH_CMAKE
+  cmDynamicLoader::FlushCache();
+#endif
+  return ret;
+}
+
 //----------------------------------------------------------------------------
 static int do_build(int ac, char** av)
 {
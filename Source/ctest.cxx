@@ -211,6 +211,32 @@ static const char * cmDocumentationOptions[][3] =
   {"--schedule-random", "Use a random order for scheduling tests",
    "This option will run the tests in a random order. It is commonly used to "
    "detect implicit dependencies in a test suite." },
+  {"--schedule-critical-path", "Start tests on long dependency chains first",
+   "This option orders tests by their recorded cost plus the cost of the "
+   "longest chain of tests that depend on them through the DEPENDS "
+   "property, so that long chains do not serialize the end of a parallel "
+   "run.  The run time predicted from the recorded costs is printed "
+   "along with the actual run time." },
+  {"--shard <k>/<n>", "Run shard k of n disjoint sets of the tests",
+   "This option splits the tests into n sets of about equal cost and runs "
+   "the k-th set, counting from 1, so that n machines can share a test "
+   "run.  Tests joined by the DEPENDS or RESOURCE_LOCK properties go to "
+   "the same set.  Costs are taken from the test cost data recorded by "
+   "earlier runs, so all shards must see the same cost data to split the "
+   "tests the same way.  Tests without a recorded cost count as the "
+   "average." },
+  {"--workers <n>", "Run the tests in n worker ctest processes",
+   "This option starts n ctest processes in the current directory that "
+   "run the tests handed to them by this process, one at a time each.  "
+   "This process keeps the schedule, honoring test dependencies and "
+   "resource locks, and collects the results into a single report.  "
+   "It takes the place of -j." },
+  {"--worker-launcher <command>", "Launch each worker with a command",
+   "The given ;-separated command line is prepended to the command line "
+   "of each worker started by --workers.  It may place the worker in its "
+   "own control group, namespace or container.  The worker command line "
+   "includes the option --worker <k> naming the worker being launched, "
+   "counting from 1." },
   {"--submit-index", "Submit individual dashboard tests with specific index",
    "This option allows performing the same CTest action (such as test) "
    "multiple times and submit all stages to the same dashboard (Dart2 "
@@ -946,6 +946,41 @@ typedef struct kwsysProcessWaitData_s
 static int kwsysProcessWaitForPipe(kwsysProcess* cp, char** data, int* length,
                                    kwsysProcessWaitData* wd);
 
+/*--------------------------------------------------------------------------*/
+int kwsysProcess_GetPipeHandles(kwsysProcess* cp,
+                                kwsysProcess_Pipe_Handle* handles,
+                                int count)
+{
+#if KWSYSPE_USE_SELECT
+  int i;
+  int n = 0;
+
+  /* WaitForData does not wait unless a process is executing.  */
+  if(!cp || cp->State != kwsysProcess_State_Executing || cp->Killed ||
+     cp->TimeoutExpired)
+    {
+    return 0;
+    }
+
+  /* The signal pipe is among the pipes that are still open, so the
+     child's termination wakes a caller waiting on them.  */
+  for(i=0; i < KWSYSPE_PIPE_COUNT && n < count; ++i)
+    {
+    if(cp->PipeReadEnds[i] >= 0)
+      {
+      handles[n++] = cp->PipeReadEnds[i];
+      }
+    }
+  return n;
+#else
+  /* The pipes are polled without select.  */
+  (void)cp;
+  (void)handles;
+  (void)count;
+  return -1;
+#endif
+}
+
 /*--------------------------------------------------------------------------*/
 int kwsysProcess_WaitForData(kwsysProcess* cp, char** data, int* length,
                              double* userTimeout)
@@ -1216,6 +1216,19 @@ void kwsysProcess_Disown(kwsysProcess* cp)
   cp->State = kwsysProcess_State_Disowned;
 }
 
+/*--------------------------------------------------------------------------*/
+int kwsysProcess_GetPipeHandles(kwsysProcess* cp,
+                                kwsysProcess_Pipe_Handle* handles,
+                                int count)
+{
+  /* The pipe threads report data through events owned by the process
+     object and not by the pipes themselves.  */
+  (void)cp;
+  (void)handles;
+  (void)count;
+  return -1;
+}
+
 /*--------------------------------------------------------------------------*/
 
 int kwsysProcess_WaitForData(kwsysProcess* cp, char** data, int* length,
@@ -62,6 +62,10 @@
 #include <signal.h>    /* sigprocmask */
 #endif
 
+#if defined(__linux__)
+# include <sys/sendfile.h>
+#endif
+
 // Windows API.
 #if defined(_WIN32)
 # include <windows.h>
@@ -1749,7 +1753,7 @@ bool SystemTools::CopyFileIfDifferent(const char* source,
   return true;
 }
 
-#define KWSYS_ST_BUFFER 4096
+#define KWSYS_ST_BUFFER 65536
 
 bool SystemTools::FilesDiffer(const char* source,
                               const char* destination)
@@ -1791,8 +1795,10 @@ bool SystemTools::FilesDiffer(const char* source,
     }
 
   // Compare the files a block at a time.
-  char source_buf[KWSYS_ST_BUFFER];
-  char dest_buf[KWSYS_ST_BUFFER];
+  kwsys_stl::vector<char> source_vec(KWSYS_ST_BUFFER);
+  kwsys_stl::vector<char> dest_vec(KWSYS_ST_BUFFER);
+  char* source_buf = &source_vec[0];
+  char* dest_buf = &dest_vec[0];
   off_t nleft = statSource.st_size;
   while(nleft > 0)
     {
@@ -1825,6 +1831,65 @@ bool SystemTools::FilesDiffer(const char* source,
 }
 
 
+#if defined(__linux__)
+//----------------------------------------------------------------------------
+// Copy the content of a file inside the kernel.  Returns 1 on success,
+// 0 on failure, or -1 if the kernel cannot copy between these files
+// and nothing was written, in which case the caller should copy.
+static int SystemToolsCopyFileKernel(const char* source,
+                                     const char* destination)
+{
+  int in = open(source, O_RDONLY);
+  if(in < 0)
+    {
+    return 0;
+    }
+  struct stat statSource;
+  if(fstat(in, &statSource) != 0)
+    {
+    close(in);
+    return 0;
+    }
+  int out = open(destination, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if(out < 0)
+    {
+    close(in);
+    return 0;
+    }
+  int result = 1;
+  off_t left = statSource.st_size;
+  bool first = true;
+  while(left > 0)
+    {
+    size_t chunk = (left > 0x40000000)? 0x40000000 :
+      static_cast<size_t>(left);
+    ssize_t n = sendfile(out, in, 0, chunk);
+    if(n < 0 && errno == EINTR)
+      {
+      continue;
+      }
+    if(n < 0)
+      {
+      result = (first && (errno == EINVAL || errno == ENOSYS))? -1 : 0;
+      break;
+      }
+    if(n == 0)
+      {
+      // The source became shorter.  The caller compares the sizes.
+      break;
+      }
+    left -= n;
+    first = false;
+    }
+  close(in);
+  if(close(out) != 0 && result == 1)
+    {
+    result = 0;
+    }
+  return result;
+}
+#endif
+
 //----------------------------------------------------------------------------
 /**
  * Copy a file named by "source" to the file named by "destination".
@@ -1840,9 +1905,6 @@ bool SystemTools::CopyFileAlways(const char* source, const char* destination,
   mode_t perm = 0;
   bool perms = SystemTools::GetPermissions(source, perm);
 
-  const int bufferSize = 4096;
-  char buffer[bufferSize];
-
   // If destination is a directory, try to create a file with the same
   // name as the source in that directory.
 
@@ -1883,39 +1945,54 @@ bool SystemTools::CopyFileAlways(const char* source, const char* destination,
   // that do not allow file removal can be modified.
   SystemTools::RemoveFile(destination);
 
-#if defined(_WIN32) || defined(__CYGWIN__)
-  kwsys_ios::ofstream fout(destination, 
-                     kwsys_ios::ios::binary | kwsys_ios::ios::out | kwsys_ios::ios::trunc);
-#else
-  kwsys_ios::ofstream fout(destination, 
-                     kwsys_ios::ios::out | kwsys_ios::ios::trunc);
-#endif
-  if(!fout)
+  bool copied = false;
+#if defined(__linux__)
+  // Let the kernel copy the data without passing it through user space.
+  int kernelCopy = SystemToolsCopyFileKernel(source, destination);
+  if(kernelCopy == 0)
     {
     return false;
     }
-  
-  // This copy loop is very sensitive on certain platforms with
-  // slightly broken stream libraries (like HPUX).  Normally, it is
-  // incorrect to not check the error condition on the fin.read()
-  // before using the data, but the fin.gcount() will be zero if an
-  // error occurred.  Therefore, the loop should be safe everywhere.
-  while(fin)
-    {
-    fin.read(buffer, bufferSize);
-    if(fin.gcount())
+  copied = kernelCopy > 0;
+#endif
+
+  if(!copied)
+    {
+#if defined(_WIN32) || defined(__CYGWIN__)
+    kwsys_ios::ofstream fout(destination, 
+                       kwsys_ios::ios::binary | kwsys_ios::ios::out | kwsys_ios::ios::trunc);
+#else
+    kwsys_ios::ofstream fout(destination, 
+                       kwsys_ios::ios::out | kwsys_ios::ios::trunc);
+#endif
+    if(!fout)
       {
-      fout.write(buffer, fin.gcount());
+      return false;
       }
+
+    // This copy loop is very sensitive on certain platforms with
+    // slightly broken stream libraries (like HPUX).  Normally, it is
+    // incorrect to not check the error condition on the fin.read()
+    // before using the data, but the fin.gcount() will be zero if an
+    // error occurred.  Therefore, the loop should be safe everywhere.
+    kwsys_stl::vector<char> buffer(KWSYS_ST_BUFFER);
+    while(fin)
+      {
+      fin.read(&buffer[0], KWSYS_ST_BUFFER);
+      if(fin.gcount())
+        {
+        fout.write(&buffer[0], fin.gcount());
+        }
+      }
+
+    // Make sure the operating system has finished writing the file
+    // before closing it.  This will ensure the file is finished before
+    // the check below.
+    fout.flush();
+    fout.close();
     }
-  
-  // Make sure the operating system has finished writing the file
-  // before closing it.  This will ensure the file is finished before
-  // the check below.
-  fout.flush();
-  
+
   fin.close();
-  fout.close();
 
   // More checks.
   struct stat statSource, statDestination;
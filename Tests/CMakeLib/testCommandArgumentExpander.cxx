@@ -0,0 +1,200 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "testCommandArgumentExpander.h"
+
+#include "cmCommandArgumentExpander.h"
+#include "cmCommandArgumentParserHelper.h"
+#include "cmGlobalGenerator.h"
+#include "cmListFileCache.h"
+#include "cmLocalGenerator.h"
+#include "cmMakefile.h"
+#include "cmake.h"
+
+#include <cmsys/Glob.hxx>
+
+#include <stdio.h>
+
+// Strings the expander must accept.
+static const char* const accepted_strings[] = {
+  "plain text",
+  "${A}",
+  "x${A}y${B}z",
+  "${UNDEFINED}",
+  "${${NAME_OF_A}}",
+  "${A_${SUFFIX}}",
+  "${A${UNDEFINED}}",
+  "$ENV{PATH}",
+  "$ENV{${ENV_NAME}}",
+  "@A@ and @UNDEFINED@",
+  "${@NAME_OF_A@}",
+  "a@b $ c { } d@",
+  "${}",
+  "\\${A} \\\" \\  \\# \\( \\) \\@ \\^ \\; \\t\\n\\r\\0",
+  "${CMAKE_CURRENT_LIST_LINE}",
+  "${QUOTED}",
+  0
+};
+
+// Strings the expander must leave to the parser.
+static const char* const rejected_strings[] = {
+  "${A",
+  "${A B}",
+  "${A{B}}",
+  "${A\\B}",
+  "$CACHE{A}",
+  "$OTHER{A}",
+  "$ENV{ PATH}",
+  "\\q",
+  "trailing\\",
+  0
+};
+
+//----------------------------------------------------------------------------
+class testCommandArgumentExpanderRun
+{
+public:
+  testCommandArgumentExpanderRun(cmMakefile* mf): Makefile(mf)
+    {
+    this->Accepted = 0;
+    this->Failed = 0;
+    }
+
+  // Compare the expander with the parser under every mode.
+  void Check(std::string const& in)
+    {
+    for(int mode = 0; mode < 16; ++mode)
+      {
+      this->Check(in, (mode & 1) != 0, (mode & 2) != 0,
+                  (mode & 4) != 0, (mode & 8) != 0);
+      }
+    }
+
+  bool Accepts(std::string const& in)
+    {
+    cmCommandArgumentExpander expander(this->Makefile);
+    std::string out;
+    return expander.Expand(in, out);
+    }
+
+  cmMakefile* Makefile;
+  int Accepted;
+  int Failed;
+
+private:
+  void Check(std::string const& in, bool escapeQuotes, bool noEscapes,
+             bool replaceAt, bool removeEmpty)
+    {
+    cmCommandArgumentExpander expander(this->Makefile);
+    expander.SetLineFile(42);
+    expander.SetEscapeQuotes(escapeQuotes);
+    expander.SetNoEscapeMode(noEscapes);
+    expander.SetReplaceAtSyntax(replaceAt);
+    expander.SetRemoveEmpty(removeEmpty);
+    std::string expanded;
+    if(!expander.Expand(in, expanded))
+      {
+      return;
+      }
+    ++this->Accepted;
+
+    cmCommandArgumentParserHelper parser;
+    parser.SetMakefile(this->Makefile);
+    parser.SetLineFile(42, "test");
+    parser.SetEscapeQuotes(escapeQuotes);
+    parser.SetNoEscapeMode(noEscapes);
+    parser.SetReplaceAtSyntax(replaceAt);
+    parser.SetRemoveEmpty(removeEmpty);
+    int res = parser.ParseString(in.c_str(), 0);
+    if(!res || parser.GetError()[0])
+      {
+      ++this->Failed;
+      printf("FAIL: parser rejects [%s] (mode %d%d%d%d)\n", in.c_str(),
+             escapeQuotes, noEscapes, replaceAt, removeEmpty);
+      }
+    else if(expanded != parser.GetResult())
+      {
+      ++this->Failed;
+      printf("FAIL: [%s] (mode %d%d%d%d) expands to [%s], not [%s]\n",
+             in.c_str(), escapeQuotes, noEscapes, replaceAt, removeEmpty,
+             expanded.c_str(), parser.GetResult().c_str());
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+int testCommandArgumentExpander(int, char*[])
+{
+  cmake cm;
+  cmGlobalGenerator gg;
+  gg.SetCMakeInstance(&cm);
+  cmsys::auto_ptr<cmLocalGenerator> lg(gg.CreateLocalGenerator());
+  cmMakefile* mf = lg->GetMakefile();
+  mf->AddDefinition("A", "value of A");
+  mf->AddDefinition("B", "b");
+  mf->AddDefinition("NAME_OF_A", "A");
+  mf->AddDefinition("SUFFIX", "B");
+  mf->AddDefinition("A_B", "value of A_B");
+  mf->AddDefinition("ENV_NAME", "PATH");
+  mf->AddDefinition("QUOTED", "say \"hi\"");
+
+  testCommandArgumentExpanderRun run(mf);
+  int result = 0;
+  for(const char* const* s = accepted_strings; *s; ++s)
+    {
+    if(!run.Accepts(*s))
+      {
+      printf("FAIL: expander rejects [%s]\n", *s);
+      result = 1;
+      }
+    run.Check(*s);
+    }
+  for(const char* const* s = rejected_strings; *s; ++s)
+    {
+    if(run.Accepts(*s))
+      {
+      printf("FAIL: expander accepts [%s]\n", *s);
+      result = 1;
+      }
+    }
+
+  // Compare on every argument in the modules shipped with CMake.
+  cmsys::Glob g;
+  g.FindFiles(MODULES_DIR "/*.cmake");
+  std::vector<std::string> const& files = g.GetFiles();
+  int arguments = 0;
+  for(std::vector<std::string>::const_iterator fi = files.begin();
+      fi != files.end(); ++fi)
+    {
+    cmListFile lf;
+    if(!lf.ParseFile(fi->c_str(), false, mf))
+      {
+      continue;
+      }
+    for(std::vector<cmListFileFunction>::const_iterator f =
+          lf.Functions.begin(); f != lf.Functions.end(); ++f)
+      {
+      for(std::vector<cmListFileArgument>::const_iterator a =
+            f->Arguments.begin(); a != f->Arguments.end(); ++a)
+        {
+        ++arguments;
+        run.Check(a->Value);
+        }
+      }
+    }
+  printf("%d files, %d arguments, %d expansions compared\n",
+         static_cast<int>(files.size()), arguments, run.Accepted);
+  if(run.Failed)
+    {
+    result = 1;
+    }
+  return result;
+}
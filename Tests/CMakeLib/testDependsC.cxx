@@ -0,0 +1,113 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "testDependsC.h"
+
+#include "cmDependsC.h"
+#include "cmSystemTools.h"
+
+#include <cmsys/Glob.hxx>
+#include <cmsys/RegularExpression.hxx>
+
+#include <stdio.h>
+
+// The include directive expression documented in cmDependsC.cxx.
+#define TEST_INCLUDE_REGEX_LINE \
+  "^[ \t]*#[ \t]*(include|import)[ \t]*[<\"]([^\">]+)([\">])"
+
+static const char* const test_lines[] = {
+  "#include <a.h>",
+  "#include \"a.h\"",
+  "  # \t include\t<sys/a.h>  // comment",
+  "#import <Foundation/Foundation.h>",
+  "#include<a.h>",
+  "#include \"a.h>",
+  "#include <a<b.h>",
+  "#include <a.h",
+  "#include <>",
+  "#include \"\"",
+  "#include MACRO_NAME",
+  "#include_next <a.h>",
+  "#includes <a.h>",
+  "#imports <a.h>",
+  "#inclu",
+  "#",
+  "",
+  "int x; #include <a.h>",
+  "// #include <a.h>",
+  "#define X <a.h>",
+  "\t#include \"dir/with space/a.h\"",
+  0
+};
+
+//----------------------------------------------------------------------------
+static bool testDependsCLine(cmsys::RegularExpression& regex,
+                             std::string const& line)
+{
+  std::string fileName;
+  bool quoted = false;
+  bool found = cmDependsC::ParseIncludeLine(line.c_str(),
+                                            line.c_str() + line.size(),
+                                            fileName, quoted);
+  bool expected = regex.find(line.c_str());
+  if(found != expected)
+    {
+    printf("FAIL: [%s] %s\n", line.c_str(),
+           found? "matches only the tokenizer" : "matches only the regex");
+    return false;
+    }
+  if(found && (fileName != regex.match(2) ||
+               quoted != (regex.match(3) == "\"")))
+    {
+    printf("FAIL: [%s] gives [%s] %s, not [%s] %s\n", line.c_str(),
+           fileName.c_str(), quoted? "quoted" : "bracketed",
+           regex.match(2).c_str(), regex.match(3).c_str());
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int testDependsC(int, char*[])
+{
+  cmsys::RegularExpression regex(TEST_INCLUDE_REGEX_LINE);
+  int result = 0;
+  for(const char* const* l = test_lines; *l; ++l)
+    {
+    if(!testDependsCLine(regex, *l))
+      {
+      result = 1;
+      }
+    }
+
+  // Compare every line of the CMake sources.
+  cmsys::Glob glob;
+  glob.FindFiles(SOURCE_DIR "/*.[ch]*");
+  std::vector<std::string> const& files = glob.GetFiles();
+  int lines = 0;
+  for(std::vector<std::string>::const_iterator f = files.begin();
+      f != files.end(); ++f)
+    {
+    std::ifstream fin(f->c_str());
+    std::string line;
+    while(cmSystemTools::GetLineFromStream(fin, line))
+      {
+      ++lines;
+      if(!testDependsCLine(regex, line))
+        {
+        result = 1;
+        }
+      }
+    }
+  printf("%d files, %d lines compared\n",
+         static_cast<int>(files.size()), lines);
+  return result;
+}